@@ -0,0 +1,62 @@
+/* Typical first-semester program: read records, sort, summarise. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_STUDENTS 100
+
+struct student {
+	char name[32];
+	int points[5];
+	double average;
+};
+
+static double average(const int *points, int n)
+{
+	int sum = 0;
+	for (int i = 0; i < n; i++)
+		sum += points[i];
+	return n ? (double)sum / n : 0.0;
+}
+
+static int by_average(const void *a, const void *b)
+{
+	const struct student *x = a, *y = b;
+	return (x->average < y->average) - (x->average > y->average);
+}
+
+static char grade(double avg)
+{
+	if (avg >= 90) return 'A';
+	if (avg >= 80) return 'B';
+	if (avg >= 70) return 'C';
+	if (avg >= 60) return 'D';
+	return 'F';
+}
+
+int main(void)
+{
+	struct student list[MAX_STUDENTS];
+	int n = 0;
+	while (n < MAX_STUDENTS && scanf("%31s", list[n].name) == 1) {
+		for (int i = 0; i < 5; i++)
+			if (scanf("%d", &list[n].points[i]) != 1)
+				list[n].points[i] = 0;
+		list[n].average = average(list[n].points, 5);
+		n++;
+	}
+	qsort(list, n, sizeof list[0], by_average);
+	int histogram[5] = {0};
+	for (int i = 0; i < n; i++) {
+		char g = grade(list[i].average);
+		histogram[g == 'F' ? 4 : g - 'A']++;
+		printf("%-20s %6.2f %c\n", list[i].name, list[i].average, g);
+	}
+	for (int i = 0; i < 5; i++) {
+		printf("%c: ", i == 4 ? 'F' : 'A' + i);
+		for (int k = 0; k < histogram[i]; k++)
+			putchar('*');
+		putchar('\n');
+	}
+	return 0;
+}
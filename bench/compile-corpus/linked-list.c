@@ -0,0 +1,101 @@
+/* Pointers, malloc and recursion: a singly linked list and a binary tree. */
+#include <stdio.h>
+#include <stdlib.h>
+
+struct node {
+	int value;
+	struct node *next;
+};
+
+struct tree {
+	int key;
+	struct tree *left, *right;
+};
+
+static struct node *push(struct node *head, int value)
+{
+	struct node *n = malloc(sizeof *n);
+	if (!n) {
+		perror("malloc");
+		exit(1);
+	}
+	n->value = value;
+	n->next = head;
+	return n;
+}
+
+static struct node *reverse(struct node *head)
+{
+	struct node *prev = NULL;
+	while (head) {
+		struct node *next = head->next;
+		head->next = prev;
+		prev = head;
+		head = next;
+	}
+	return prev;
+}
+
+static struct tree *insert(struct tree *t, int key)
+{
+	if (!t) {
+		t = calloc(1, sizeof *t);
+		t->key = key;
+	} else if (key < t->key) {
+		t->left = insert(t->left, key);
+	} else if (key > t->key) {
+		t->right = insert(t->right, key);
+	}
+	return t;
+}
+
+static int height(const struct tree *t)
+{
+	if (!t) return 0;
+	int l = height(t->left), r = height(t->right);
+	return 1 + (l > r ? l : r);
+}
+
+static void in_order(const struct tree *t)
+{
+	if (!t) return;
+	in_order(t->left);
+	printf("%d ", t->key);
+	in_order(t->right);
+}
+
+static void free_tree(struct tree *t)
+{
+	if (!t) return;
+	free_tree(t->left);
+	free_tree(t->right);
+	free(t);
+}
+
+static unsigned long long fib(int n)
+{
+	return n < 2 ? (unsigned long long)n : fib(n - 1) + fib(n - 2);
+}
+
+int main(void)
+{
+	struct node *list = NULL;
+	struct tree *root = NULL;
+	int x;
+	while (scanf("%d", &x) == 1) {
+		list = push(list, x);
+		root = insert(root, x);
+	}
+	list = reverse(list);
+	for (struct node *n = list; n; n = n->next)
+		printf("%d%s", n->value, n->next ? " -> " : "\n");
+	in_order(root);
+	printf("\nheight %d, fib(25) = %llu\n", height(root), fib(25));
+	while (list) {
+		struct node *next = list->next;
+		free(list);
+		list = next;
+	}
+	free_tree(root);
+	return 0;
+}
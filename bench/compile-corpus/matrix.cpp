@@ -0,0 +1,96 @@
+// Classes, operator overloading and iostream: a small matrix type.
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+class Matrix {
+public:
+	Matrix(std::size_t rows, std::size_t cols, double fill = 0.0) : rows_(rows), cols_(cols), data_(rows * cols, fill) {}
+
+	static Matrix identity(std::size_t n)
+	{
+		Matrix m(n, n);
+		for (std::size_t i = 0; i < n; ++i) m(i, i) = 1.0;
+		return m;
+	}
+
+	double &operator()(std::size_t r, std::size_t c) { return data_[r * cols_ + c]; }
+	double operator()(std::size_t r, std::size_t c) const { return data_[r * cols_ + c]; }
+	std::size_t rows() const { return rows_; }
+	std::size_t cols() const { return cols_; }
+
+	Matrix operator*(const Matrix &o) const
+	{
+		if (cols_ != o.rows_) throw std::invalid_argument("dimension mismatch");
+		Matrix out(rows_, o.cols_);
+		for (std::size_t i = 0; i < rows_; ++i)
+			for (std::size_t k = 0; k < cols_; ++k)
+				for (std::size_t j = 0; j < o.cols_; ++j)
+					out(i, j) += (*this)(i, k) * o(k, j);
+		return out;
+	}
+
+	Matrix transposed() const
+	{
+		Matrix t(cols_, rows_);
+		for (std::size_t i = 0; i < rows_; ++i)
+			for (std::size_t j = 0; j < cols_; ++j) t(j, i) = (*this)(i, j);
+		return t;
+	}
+
+	// Gaussian elimination with partial pivoting
+	double determinant() const
+	{
+		if (rows_ != cols_) throw std::invalid_argument("not square");
+		Matrix a = *this;
+		double det = 1.0;
+		for (std::size_t c = 0; c < cols_; ++c) {
+			std::size_t pivot = c;
+			for (std::size_t r = c + 1; r < rows_; ++r)
+				if (std::fabs(a(r, c)) > std::fabs(a(pivot, c))) pivot = r;
+			if (a(pivot, c) == 0.0) return 0.0;
+			if (pivot != c) {
+				for (std::size_t j = 0; j < cols_; ++j) std::swap(a(pivot, j), a(c, j));
+				det = -det;
+			}
+			det *= a(c, c);
+			for (std::size_t r = c + 1; r < rows_; ++r) {
+				double f = a(r, c) / a(c, c);
+				for (std::size_t j = c; j < cols_; ++j) a(r, j) -= f * a(c, j);
+			}
+		}
+		return det;
+	}
+
+private:
+	std::size_t rows_, cols_;
+	std::vector<double> data_;
+};
+
+std::ostream &operator<<(std::ostream &os, const Matrix &m)
+{
+	for (std::size_t i = 0; i < m.rows(); ++i) {
+		for (std::size_t j = 0; j < m.cols(); ++j) os << std::setw(10) << std::fixed << std::setprecision(3) << m(i, j);
+		os << '\n';
+	}
+	return os;
+}
+
+int main()
+{
+	std::size_t n;
+	if (!(std::cin >> n)) n = 3;
+	Matrix a(n, n);
+	for (std::size_t i = 0; i < n; ++i)
+		for (std::size_t j = 0; j < n; ++j) a(i, j) = static_cast<double>((i + 1) * (j + 2) % 7) - 3.0;
+	try {
+		Matrix p = a * a.transposed() * Matrix::identity(n);
+		std::cout << p << "det = " << p.determinant() << '\n';
+	} catch (const std::exception &e) {
+		std::cerr << "error: " << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,117 @@
+// libstdc++-heavy translation unit: regex, chrono, random, smart pointers,
+// variant/optional, function objects and (with -std=c++20) ranges and format.
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <variant>
+#include <vector>
+#if __cplusplus >= 202002L && __has_include(<format>)
+#include <format>
+#include <ranges>
+#endif
+
+struct Shape {
+	virtual ~Shape() = default;
+	virtual double area() const = 0;
+	virtual std::string name() const = 0;
+};
+
+struct Circle : Shape {
+	explicit Circle(double r) : r(r) {}
+	double area() const override { return 3.141592653589793 * r * r; }
+	std::string name() const override { return "circle"; }
+	double r;
+};
+
+struct Rect : Shape {
+	Rect(double w, double h) : w(w), h(h) {}
+	double area() const override { return w * h; }
+	std::string name() const override { return "rect"; }
+	double w, h;
+};
+
+using Token = std::variant<long, double, std::string>;
+
+template <class... F>
+struct overloaded : F... {
+	using F::operator()...;
+};
+template <class... F>
+overloaded(F...) -> overloaded<F...>;
+
+static std::vector<Token> tokenize(const std::string &text)
+{
+	static const std::regex token(R"((\d+\.\d+)|(\d+)|([A-Za-z_]\w*))");
+	std::vector<Token> out;
+	for (auto it = std::sregex_iterator(text.begin(), text.end(), token); it != std::sregex_iterator(); ++it) {
+		const std::smatch &m = *it;
+		if (m[1].matched) out.emplace_back(std::stod(m[1]));
+		else if (m[2].matched) out.emplace_back(std::stol(m[2]));
+		else out.emplace_back(m[3].str());
+	}
+	return out;
+}
+
+template <class T>
+static std::optional<T> median(std::vector<T> v)
+{
+	if (v.empty()) return std::nullopt;
+	auto mid = v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2);
+	std::nth_element(v.begin(), mid, v.end());
+	return *mid;
+}
+
+int main()
+{
+	auto start = std::chrono::steady_clock::now();
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<double> dist(0.5, 3.0);
+
+	std::vector<std::unique_ptr<Shape>> shapes;
+	for (int i = 0; i < 8; ++i) {
+		if (i % 2) shapes.push_back(std::make_unique<Circle>(dist(rng)));
+		else shapes.push_back(std::make_unique<Rect>(dist(rng), dist(rng)));
+	}
+	std::vector<double> areas;
+	std::transform(shapes.begin(), shapes.end(), std::back_inserter(areas), std::mem_fn(&Shape::area));
+	double total = std::accumulate(areas.begin(), areas.end(), 0.0);
+
+	std::vector<std::function<double(double)>> ops = {
+		[](double x) { return x * 2; },
+		[total](double x) { return x / total; },
+		std::negate<double>()
+	};
+	double x = 1.0;
+	for (const auto &op : ops) x = op(x);
+
+	long ints = 0;
+	double reals = 0;
+	std::vector<std::string> names;
+	for (const Token &t : tokenize("x1 = 42 + 3.5 * radius - 7 / y_2")) {
+		std::visit(overloaded{
+			[&](long v) { ints += v; },
+			[&](double v) { reals += v; },
+			[&](const std::string &s) { names.push_back(s); }
+		}, t);
+	}
+
+#if __cplusplus >= 202002L && __has_include(<format>)
+	auto big = areas | std::views::filter([](double a) { return a > 2.0; }) | std::views::transform([](double a) { return static_cast<long>(a); });
+	long big_sum = 0;
+	for (long a : big) big_sum += a;
+	std::cout << std::format("total {:.3f}, big {}, x {:.4f}\n", total, big_sum, x);
+#else
+	std::cout << "total " << total << ", x " << x << '\n';
+#endif
+	std::cout << ints << ' ' << reals << ' ' << names.size() << ' ' << median(areas).value_or(0.0) << '\n';
+	auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << us << " us\n";
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Standard containers and algorithms: word frequencies, top-k, graph search.
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static std::string normalise(std::string w)
+{
+	w.erase(std::remove_if(w.begin(), w.end(), [](unsigned char c) { return !std::isalnum(c); }), w.end());
+	std::transform(w.begin(), w.end(), w.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return w;
+}
+
+static std::vector<int> shortest_paths(const std::map<int, std::vector<std::pair<int, int>>> &graph, int source)
+{
+	std::vector<int> dist(graph.size() + 1, 1 << 30);
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;
+	dist[source] = 0;
+	pq.emplace(0, source);
+	while (!pq.empty()) {
+		auto [d, u] = pq.top();
+		pq.pop();
+		if (d > dist[u]) continue;
+		auto it = graph.find(u);
+		if (it == graph.end()) continue;
+		for (const auto &[v, w] : it->second) {
+			if (v < static_cast<int>(dist.size()) && d + w < dist[v]) {
+				dist[v] = d + w;
+				pq.emplace(dist[v], v);
+			}
+		}
+	}
+	return dist;
+}
+
+int main()
+{
+	std::unordered_map<std::string, int> freq;
+	std::set<std::string> unique;
+	std::string line;
+	std::size_t lines = 0;
+	while (std::getline(std::cin, line)) {
+		++lines;
+		std::istringstream in(line);
+		for (std::string w; in >> w;) {
+			w = normalise(w);
+			if (w.empty()) continue;
+			++freq[w];
+			unique.insert(w);
+		}
+	}
+
+	std::vector<std::pair<std::string, int>> top(freq.begin(), freq.end());
+	std::sort(top.begin(), top.end(), [](const auto &a, const auto &b) { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+	if (top.size() > 10) top.resize(10);
+	std::cout << lines << " lines, " << unique.size() << " distinct words\n";
+	for (const auto &[word, count] : top) std::cout << word << ' ' << count << '\n';
+
+	std::map<int, std::vector<std::pair<int, int>>> graph;
+	for (int i = 1; i <= 20; ++i) {
+		graph[i].emplace_back(i % 20 + 1, i % 3 + 1);
+		graph[i].emplace_back((i * 7) % 20 + 1, i % 5 + 2);
+	}
+	auto dist = shortest_paths(graph, 1);
+	std::cout << "dist(1, 20) = " << dist[20] << '\n';
+	return 0;
+}
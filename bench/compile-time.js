@@ -0,0 +1,107 @@
+// Compile time of the bundled toolchain over bench/compile-corpus, the same
+// programs build-mingw64.sh uses for PGO training. Run it against the plain
+// and the PGO/LTO toolchain and compare the two result files.
+//
+// Usage:
+//   node bench/compile-time.js [--bin "c c++/bin"] [--runs N] [--out file.json]
+//   node bench/compile-time.js --compare old.json new.json
+//
+// Every corpus file is compiled (-c) at -O0 -g and at -O2 with the app's
+// language standard (C11 / C++17); each configuration reports the median wall
+// time of N runs. The first run of each is discarded as a warmup.
+const { execFile } = require("child_process");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+
+const ROOT = path.join(__dirname, "..");
+const CORPUS = path.join(__dirname, "compile-corpus");
+const MODES = { debug: ["-O0", "-g"], release: ["-O2"] };
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+const median = v => {
+  const s = v.slice().sort((a, b) => a - b);
+  const m = s.length >> 1;
+  return s.length % 2 ? s[m] : (s[m - 1] + s[m]) / 2;
+};
+
+// ---- --compare: per-configuration and total ratios between two result files ----
+if (process.argv.includes("--compare")) {
+  const [a, b] = process.argv.slice(process.argv.indexOf("--compare") + 1).map(f => JSON.parse(fs.readFileSync(f, "utf8")));
+  const key = r => `${r.file} ${r.mode}`;
+  const old = new Map(a.results.map(r => [key(r), r]));
+  console.log(`${a.toolchain} (${a.machine.cpu})  ->  ${b.toolchain} (${b.machine.cpu})`);
+  let sumA = 0, sumB = 0;
+  for (const r of b.results) {
+    const o = old.get(key(r));
+    if (!o) continue;
+    sumA += o.ms;
+    sumB += r.ms;
+    console.log(`${key(r).padEnd(32)} ${o.ms.toFixed(0).padStart(7)} ms -> ${r.ms.toFixed(0).padStart(7)} ms  ${(r.ms / o.ms).toFixed(2)}x`);
+  }
+  console.log(`${"total".padEnd(32)} ${sumA.toFixed(0).padStart(7)} ms -> ${sumB.toFixed(0).padStart(7)} ms  ${(sumB / sumA).toFixed(2)}x`);
+  process.exit(0);
+}
+
+function compile(compiler, args) {
+  return new Promise((resolve, reject) => {
+    const start = process.hrtime.bigint();
+    execFile(compiler, args, { windowsHide: true, timeout: 300_000 }, (e, _, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve(Number(process.hrtime.bigint() - start) / 1e6);
+    });
+  });
+}
+
+async function main() {
+  const bin = path.resolve(arg("bin", path.join(ROOT, "c c++", "bin")));
+  const runs = +arg("runs", 5);
+  const exe = name => path.join(bin, process.platform === "win32" ? name + ".exe" : name);
+  const obj = path.join(os.tmpdir(), `languaggify-compile-time-${process.pid}.o`);
+  const version = (await new Promise(resolve => execFile(exe("gcc"), ["--version"], (e, out) => resolve(e ? "unknown" : out.split(/\r?\n/)[0])))).trim();
+
+  const results = [];
+  for (const file of fs.readdirSync(CORPUS).filter(f => /\.(c|cpp)$/.test(f)).sort()) {
+    const cpp = file.endsWith(".cpp");
+    for (const [mode, flags] of Object.entries(MODES)) {
+      const args = [cpp ? "-std=c++17" : "-std=c11", ...flags, "-c", "-o", obj, path.join(CORPUS, file)];
+      const times = [];
+      for (let i = 0; i <= runs; i++) {
+        const ms = await compile(exe(cpp ? "g++" : "gcc"), args);
+        if (i) times.push(ms);
+      }
+      const res = { file, mode, ms: +median(times).toFixed(1), min: +Math.min(...times).toFixed(1) };
+      results.push(res);
+      console.log(`${file.padEnd(20)} ${mode.padEnd(8)} ${res.ms.toFixed(0).padStart(6)} ms (min ${res.min.toFixed(0)})`);
+    }
+  }
+  fs.rmSync(obj, { force: true });
+  console.log(`total ${results.reduce((a, r) => a + r.ms, 0).toFixed(0)} ms`);
+
+  const report = {
+    date: new Date().toISOString(),
+    toolchain: version,
+    bin,
+    machine: {
+      host: os.hostname(),
+      cpu: os.cpus()[0] ? os.cpus()[0].model : "unknown",
+      cores: os.cpus().length,
+      platform: `${process.platform} ${os.release()}`
+    },
+    runs,
+    results
+  };
+  const out = arg("out", path.join(ROOT, "bench-results", `compile-time-${os.hostname()}-${report.date.replace(/[:.]/g, "-")}.json`));
+  fs.mkdirSync(path.dirname(out), { recursive: true });
+  fs.writeFileSync(out, JSON.stringify(report, null, 2));
+  console.log("results: " + out);
+}
+
+main().then(() => process.exit(0), err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
@@ -0,0 +1,134 @@
+// Header lookups and preprocessing time with and without the header
+// resolution map (scripts/build-header-map.js, lib/headermap.js).
+//
+// Usage:
+//   node bench/include-lookups.js [--bin "c c++/bin"] [--map "c c++/include-map"] [--runs N] [--out file.json]
+//
+// Every bench/compile-corpus file is preprocessed (-E) through the plain
+// search chain and with the map in front of it. For each it reports
+//   - failed and total file lookups: counted with strace where it is on PATH
+//     (Linux); otherwise modelled from `-H` output, one failed open per
+//     directory searched before the one a header was found in;
+//   - the median wall time of N runs (first run discarded);
+//   - whether both preprocess to the same text.
+const { execFile, execFileSync } = require("child_process");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const { searchChain } = require("../lib/headermap");
+
+const ROOT = path.join(__dirname, "..");
+const CORPUS = path.join(__dirname, "compile-corpus");
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+const median = v => {
+  const s = v.slice().sort((a, b) => a - b);
+  const m = s.length >> 1;
+  return s.length % 2 ? s[m] : (s[m - 1] + s[m]) / 2;
+};
+
+function run(exe, args) {
+  return new Promise((resolve, reject) => {
+    const start = process.hrtime.bigint();
+    execFile(exe, args, { maxBuffer: 256 * 1024 * 1024, timeout: 120_000, windowsHide: true }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve({ out, err, ms: Number(process.hrtime.bigint() - start) / 1e6 });
+    });
+  });
+}
+
+const hasStrace = (() => {
+  try {
+    execFileSync("strace", ["-V"], { stdio: "ignore" });
+    return true;
+  } catch (_) {
+    return false;
+  }
+})();
+
+async function lookupsStrace(exe, args) {
+  const log = path.join(os.tmpdir(), `languaggify-lookups-${process.pid}.log`);
+  await run("strace", ["-f", "-qq", "-e", "trace=%file", "-o", log, exe, ...args]);
+  const lines = fs.readFileSync(log, "utf8").split("\n").filter(Boolean);
+  fs.rmSync(log, { force: true });
+  return { failed: lines.filter(l => /= -1 ENOENT/.test(l)).length, total: lines.length };
+}
+
+// each header costs one failed open per chain directory searched before its own
+async function lookupsModel(exe, args, chain) {
+  const { err } = await run(exe, ["-H", ...args]);
+  const files = new Set([...err.matchAll(/^\.+ (.+)$/gm)].map(m => path.resolve(m[1].trim())));
+  let failed = 0;
+  for (const f of files) {
+    const i = chain.findIndex(d => f.startsWith(d + path.sep));
+    if (i > 0) failed += i;
+  }
+  return { failed, total: failed + files.size };
+}
+
+async function main() {
+  const bin = path.resolve(arg("bin", path.join(ROOT, "c c++", "bin")));
+  const map = path.resolve(arg("map", path.join(ROOT, "c c++", "include-map")));
+  const runs = +arg("runs", 10);
+  const exe = name => (fs.existsSync(path.join(bin, name + ".exe")) ? path.join(bin, name + ".exe") : path.join(bin, name));
+  if (!fs.existsSync(path.join(map, "manifest.json"))) throw new Error("no header map at " + map + " (run scripts/build-header-map.js)");
+  console.log(`lookups: ${hasStrace ? "strace" : "modelled from -H (strace not found)"}`);
+
+  const results = [];
+  for (const file of fs.readdirSync(CORPUS).filter(f => /\.(c|cpp)$/.test(f)).sort()) {
+    const cpp = file.endsWith(".cpp");
+    const lang = cpp ? "c++" : "c";
+    const compiler = exe(cpp ? "g++" : "gcc");
+    const base = [cpp ? "-std=c++17" : "-std=c11", "-O2", "-E", "-P", path.join(CORPUS, file)];
+    const res = { file };
+    const text = {};
+    for (const [name, extra] of [["chain", []], ["map", ["-isystem", path.join(map, lang)]]]) {
+      const args = [...extra, ...base];
+      const chain = await searchChain(compiler, lang, extra);
+      const times = [];
+      for (let i = 0; i <= runs; i++) {
+        const r = await run(compiler, args);
+        if (i) times.push(r.ms);
+        else text[name] = r.out;
+      }
+      const lookups = hasStrace ? await lookupsStrace(compiler, args) : await lookupsModel(compiler, args, chain);
+      res[name] = { ...lookups, ms: +median(times).toFixed(1) };
+    }
+    res.identical = text.chain === text.map;
+    results.push(res);
+    console.log(`${file.padEnd(18)} failed lookups ${String(res.chain.failed).padStart(5)} -> ${String(res.map.failed).padStart(5)}  ` +
+      `total ${String(res.chain.total).padStart(5)} -> ${String(res.map.total).padStart(5)}  ` +
+      `${res.chain.ms.toFixed(1).padStart(7)} ms -> ${res.map.ms.toFixed(1).padStart(7)} ms  ${res.identical ? "same output" : "OUTPUT DIFFERS"}`);
+  }
+
+  const sum = (k, f) => results.reduce((n, r) => n + r[k][f], 0);
+  console.log(`total              failed lookups ${sum("chain", "failed")} -> ${sum("map", "failed")}, ` +
+    `${sum("chain", "ms").toFixed(0)} ms -> ${sum("map", "ms").toFixed(0)} ms`);
+
+  const report = {
+    date: new Date().toISOString(),
+    bin,
+    map,
+    method: hasStrace ? "strace" : "model",
+    machine: {
+      host: os.hostname(),
+      cpu: os.cpus()[0] ? os.cpus()[0].model : "unknown",
+      platform: `${process.platform} ${os.release()}`
+    },
+    runs,
+    results
+  };
+  const out = arg("out", path.join(ROOT, "bench-results", `include-lookups-${os.hostname()}-${report.date.replace(/[:.]/g, "-")}.json`));
+  fs.mkdirSync(path.dirname(out), { recursive: true });
+  fs.writeFileSync(out, JSON.stringify(report, null, 2));
+  console.log("results: " + out);
+}
+
+main().then(() => process.exit(0), err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
@@ -0,0 +1,53 @@
+// Kernel timings for bench/parallel-stl.js: std::sort, std::accumulate and
+// std::reduce(std::execution::par) over n doubles, each repeated `reps` times.
+// Prints "<kernel> <median ms> <checksum>" per kernel.
+//
+// Built once with the default profile and once with -fopenmp -D_GLIBCXX_PARALLEL;
+// in the second build libstdc++ parallel mode replaces std::sort and
+// std::accumulate with OpenMP versions, so the source is the same for both.
+// std::reduce(par) stays serial in both: its parallel (pstl) backend is TBB,
+// which is not bundled. It is timed as a control, not for a speedup.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <vector>
+
+template <class F>
+static double median_ms(int reps, F run) {
+  std::vector<double> t;
+  for (int r = 0; r < reps; r++) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    t.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+  std::sort(t.begin(), t.end());
+  return t.size() % 2 ? t[t.size() / 2] : (t[t.size() / 2 - 1] + t[t.size() / 2]) / 2;
+}
+
+int main(int argc, char** argv) {
+  const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+  const int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::vector<double> input(n);
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  for (auto& x : input) x = dist(rng);
+
+  std::vector<double> work;
+  double check = 0;
+  // the copy back to unsorted input is part of each sort rep; it is small next to the sort
+  double ms = median_ms(reps, [&] { work = input; std::sort(work.begin(), work.end()); });
+  check = work[n / 2];
+  std::printf("sort %.3f %.6f\n", ms, check);
+
+  ms = median_ms(reps, [&] { check = std::accumulate(input.begin(), input.end(), 0.0); });
+  std::printf("accumulate %.3f %.6f\n", ms, check);
+
+  ms = median_ms(reps, [&] { check = std::reduce(std::execution::par, input.begin(), input.end(), 0.0); });
+  std::printf("reduce %.3f %.6f\n", ms, check);
+  return 0;
+}
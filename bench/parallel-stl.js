@@ -0,0 +1,100 @@
+// std::sort / std::accumulate speedups from the C++ "parallel" build profile
+// (libstdc++ parallel mode on OpenMP) over the default build of the same
+// source, bench/parallel-stl.cpp. std::reduce(par) is listed as a serial
+// control: without TBB its pstl backend is serial in both builds, so it gets
+// no speedup column.
+//
+// Usage:
+//   node bench/parallel-stl.js [--n 20000000] [--reps 5] [--threads 1,2,4,8] [--out file.json]
+//
+// The default build runs once; the parallel build runs once per thread count
+// with OMP_NUM_THREADS set. Each run reports the median of `reps` repetitions
+// per kernel, timed inside the program (input generation is not included).
+const { exec, execFile } = require("child_process");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const cpp = require("../languages/cpp");
+const { threadCounts } = require("../lib/bench");
+
+const ROOT = path.join(__dirname, "..");
+const SOURCE = path.join(__dirname, "parallel-stl.cpp");
+// kernels that run serially in the parallel build too (no pstl parallel backend)
+const SERIAL_ONLY = ["reduce"];
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+// both builds use the serial pstl backend (there is no other), so std::reduce(par) is the same code in both
+function build(profile, out) {
+  return new Promise((resolve, reject) => {
+    exec(cpp.compile(SOURCE, { profile, out, flags: profile === "parallel" ? [] : ["-D_GLIBCXX_USE_TBB_PAR_BACKEND=0"] }), { timeout: 120_000 }, (e, _, err) => (e ? reject(new Error(String(err || e.message).trim())) : resolve(out)));
+  });
+}
+
+// -> { sort: ms, accumulate: ms, reduce: ms }
+function run(exe, n, reps, threads) {
+  const env = { ...process.env };
+  if (threads) env.OMP_NUM_THREADS = String(threads);
+  else delete env.OMP_NUM_THREADS;
+  return new Promise((resolve, reject) => {
+    execFile(exe, [String(n), String(reps)], { env, timeout: 600_000 }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      const ms = {};
+      for (const [, kernel, t] of out.matchAll(/^(\w+) ([\d.]+) /gm)) ms[kernel] = +t;
+      resolve(ms);
+    });
+  });
+}
+
+async function main() {
+  const n = +arg("n", 20_000_000);
+  const reps = +arg("reps", 5);
+  const threads = arg("threads") ? arg("threads").split(",").map(Number) : threadCounts(os.cpus().length);
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), "languaggify-pstl-"));
+
+  try {
+    const serialExe = await build("default", path.join(dir, "pstl-default.exe"));
+    const parallelExe = await build("parallel", path.join(dir, "pstl-parallel.exe"));
+
+    const serial = await run(serialExe, n, reps, 0);
+    const kernels = Object.keys(serial);
+    const parallel = kernels.filter(k => !SERIAL_ONLY.includes(k));
+    const cell = (k, ms) => (SERIAL_ONLY.includes(k) ? `${ms.toFixed(1)} ms` : `${ms.toFixed(1)} ms ${(serial[k] / ms).toFixed(2)}×`).padStart(22);
+    console.log(`n=${n} reps=${reps}  ${os.cpus()[0] ? os.cpus()[0].model : ""} (${os.cpus().length} logical CPUs)`);
+    console.log("threads".padEnd(10) + kernels.map(k => (SERIAL_ONLY.includes(k) ? k + " (serial)" : k).padStart(22)).join(""));
+    console.log("default".padEnd(10) + kernels.map(k => `${serial[k].toFixed(1)} ms`.padStart(22)).join(""));
+
+    const results = [];
+    for (const t of threads) {
+      const ms = await run(parallelExe, n, reps, t);
+      results.push({ threads: t, ms, speedup: Object.fromEntries(parallel.map(k => [k, +(serial[k] / ms[k]).toFixed(3)])) });
+      console.log(String(t).padEnd(10) + kernels.map(k => cell(k, ms[k])).join(""));
+    }
+    console.log("(serial): no pstl parallel backend (TBB) bundled; std::reduce(par) runs serially in both builds");
+
+    const report = {
+      date: new Date().toISOString(),
+      machine: {
+        host: os.hostname(),
+        cpu: os.cpus()[0] ? os.cpus()[0].model : "unknown",
+        cores: os.cpus().length,
+        platform: `${process.platform} ${os.release()}`
+      },
+      n, reps, flags: cpp.profiles.parallel, serialOnly: SERIAL_ONLY, serial, results
+    };
+    const out = arg("out", path.join(ROOT, "bench-results", `parallel-stl-${os.hostname()}-${report.date.replace(/[:.]/g, "-")}.json`));
+    fs.mkdirSync(path.dirname(out), { recursive: true });
+    fs.writeFileSync(out, JSON.stringify(report, null, 2));
+    console.log("results: " + out);
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+}
+
+main().then(() => process.exit(0), err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
@@ -0,0 +1,220 @@
+// End-to-end run latency for all four languages, through the real run-code
+// and run-exe handlers from main.js (loaded headless, no window).
+//
+// Usage:
+//   npx electron bench/run-latency.js [--runs N] [--lang c,cpp,...] [--out file.json]
+//   node bench/run-latency.js --compare old.json new.json
+//
+// Programs are the `examples` table from index.html (interactive "User Input"
+// ones are skipped) plus heavier generated programs. For every language,
+// build profile and program the first iteration is reported as cold and the
+// rest as warm, with p50/p95 of:
+//   build  run-code (write source + compile for C/C++)
+//   ttfo   time to first output byte, from the start of the iteration
+//   total  until the process has exited
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const vm = require("vm");
+
+const ROOT = path.join(__dirname, "..");
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+function pct(values, p) {
+  const s = values.slice().sort((a, b) => a - b);
+  return s.length ? +s[Math.min(s.length - 1, Math.floor(p * s.length))].toFixed(1) : null;
+}
+
+// ---- --compare: print warm p50 ratios between two result files ----
+if (process.argv.includes("--compare")) {
+  const [a, b] = process.argv.slice(process.argv.indexOf("--compare") + 1).map(f => JSON.parse(fs.readFileSync(f, "utf8")));
+  const key = r => `${r.lang}/${r.profile}/${r.program}`;
+  const old = new Map(a.results.map(r => [key(r), r]));
+  console.log(`${a.machine.cpu} (${a.version})  ->  ${b.machine.cpu} (${b.version})`);
+  for (const r of b.results) {
+    const o = old.get(key(r));
+    if (!o) continue;
+    const ratio = m => (o.warm[m].p50 ? (r.warm[m].p50 / o.warm[m].p50).toFixed(2) + "x" : "-");
+    console.log(`${key(r).padEnd(40)} build ${ratio("build")}  ttfo ${ratio("ttfo")}  total ${ratio("total")}`);
+  }
+  process.exit(0);
+}
+
+// ---- programs ----
+function examplePrograms() {
+  const html = fs.readFileSync(path.join(ROOT, "index.html"), "utf8");
+  const start = html.indexOf("const examples = {");
+  const end = html.indexOf("\n};", start);
+  const table = vm.runInNewContext("(" + html.slice(start + "const examples = ".length, end + 2) + ")");
+  const out = {};
+  for (const [lang, list] of Object.entries(table)) {
+    out[lang] = list.filter(ex => !/input/i.test(ex.name)).map(ex => ({ name: ex.name, code: ex.code }));
+  }
+  return out;
+}
+
+const generated = {
+  c: {
+    name: "Sieve 5M (generated)",
+    code: `#include <stdio.h>
+#include <stdlib.h>
+int main(void) {
+    int n = 5000000, count = 0;
+    char *s = calloc(n + 1, 1);
+    for (int i = 2; i <= n; i++) {
+        if (s[i]) continue;
+        if (++count % 100 == 0) printf("%d\\n", i);
+        for (long long j = (long long)i * i; j <= n; j += i) s[j] = 1;
+    }
+    printf("primes: %d\\n", count);
+    free(s);
+    return 0;
+}`
+  },
+  cpp: {
+    name: "STL heavy (generated)",
+    code: `#include <algorithm>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+int main() {
+    std::mt19937 rng(42);
+    std::vector<int> v(2000000);
+    for (auto &x : v) x = rng() % 100000;
+    std::sort(v.begin(), v.end());
+    std::map<int, int> freq;
+    for (int x : v) ++freq[x % 1000];
+    std::unordered_map<std::string, long long> sums;
+    for (auto &[k, c] : freq) sums[std::to_string(k % 10)] += c;
+    for (auto &[k, s] : sums) std::cout << k << " " << s << "\\n";
+    std::cout << std::accumulate(v.begin(), v.end(), 0LL) << "\\n";
+    return 0;
+}`
+  },
+  python: {
+    name: "Loop 2M (generated)",
+    code: `total = 0
+for i in range(2_000_000):
+    total += i * i % 7
+    if i % 20000 == 0:
+        print(i, total)
+print("total", total)`
+  },
+  javascript: {
+    name: "Loop 5M (generated)",
+    code: `let total = 0;
+for (let i = 0; i < 5000000; i++) {
+  total += i * i % 7;
+  if (i % 50000 === 0) print(i, total);
+}
+print("total", total);`
+  }
+};
+
+// ---- bench ----
+async function main() {
+  process.env.LANGUAGGIFY_HEADLESS = "1";
+  const { app } = require("electron");
+  const { runCode, runExe } = require("../main.js");
+  const languages = require("../languages");
+  await app.whenReady();
+
+  const runs = parseInt(arg("runs", "6"), 10);
+  const langs = arg("lang", "c,cpp,python,javascript").split(",");
+  const examples = examplePrograms();
+  const now = () => performance.now();
+
+  // run the program via run-exe and time first byte / exit
+  const launch = (argv, t0) => new Promise(resolve => {
+    let ttfo = null;
+    const timer = setTimeout(() => resolve({ ttfo, total: null, error: "timeout" }), 60_000);
+    const sender = {
+      send(_, d) {
+        const t = now();
+        if (String(d).startsWith("\n[process exited")) {
+          clearTimeout(timer);
+          resolve({ ttfo, total: t - t0, code: parseInt(String(d).slice(17), 10) });
+        } else if (ttfo === null) {
+          ttfo = t - t0;
+        }
+      }
+    };
+    runExe(sender, argv[0], argv.slice(1)).then(r => {
+      if (r !== "started") { clearTimeout(timer); resolve({ ttfo, total: null, error: r }); }
+    });
+  });
+
+  const results = [];
+  for (const lang of langs) {
+    const cfg = languages[lang];
+    if (!cfg) continue;
+    const compiled = !!cfg.compile;
+    const file = path.join(ROOT, "temp", cfg.filename);
+    const programs = (examples[lang] || []).concat(generated[lang] ? [generated[lang]] : []);
+    for (const profile of Object.keys(cfg.profiles || { default: null })) {
+      for (const prog of programs) {
+        const samples = [];
+        for (let i = 0; i < runs; i++) {
+          const t0 = now();
+          const opts = compiled ? { runInTerminal: true, action: "compile", profile } : { runInTerminal: true, profile };
+          const built = await runCode({ lang, code: prog.code, opts });
+          const build = now() - t0;
+          if (compiled && !(built && built.compiled)) {
+            samples.push({ build, error: String(built) });
+            break;
+          }
+          const run = await launch(cfg.argv(file), t0);
+          samples.push({ build, ...run });
+        }
+        const ok = samples.filter(s => s.total != null);
+        const summary = list => ({
+          build: { p50: pct(list.map(s => s.build), 0.5), p95: pct(list.map(s => s.build), 0.95) },
+          ttfo: { p50: pct(list.filter(s => s.ttfo != null).map(s => s.ttfo), 0.5), p95: pct(list.filter(s => s.ttfo != null).map(s => s.ttfo), 0.95) },
+          total: { p50: pct(list.map(s => s.total), 0.5), p95: pct(list.map(s => s.total), 0.95) }
+        });
+        const res = {
+          lang, profile, program: prog.name,
+          cold: ok[0] ? { build: +ok[0].build.toFixed(1), ttfo: ok[0].ttfo && +ok[0].ttfo.toFixed(1), total: +ok[0].total.toFixed(1) } : null,
+          warm: summary(ok.slice(1)),
+          errors: samples.filter(s => s.error).map(s => s.error)
+        };
+        results.push(res);
+        console.log(`${lang}/${profile}/${prog.name}: cold ${res.cold ? res.cold.total : "-"} ms, warm p50 ${res.warm.total.p50} ms (ttfo ${res.warm.ttfo.p50} ms)`);
+      }
+    }
+  }
+
+  const pkg = require("../package.json");
+  const report = {
+    version: pkg.version,
+    date: new Date().toISOString(),
+    machine: {
+      host: os.hostname(),
+      cpu: os.cpus()[0] ? os.cpus()[0].model : "unknown",
+      cores: os.cpus().length,
+      memGB: +(os.totalmem() / 1073741824).toFixed(1),
+      platform: `${process.platform} ${os.release()}`,
+      electron: process.versions.electron
+    },
+    runs,
+    results
+  };
+  const out = arg("out", path.join(ROOT, "bench-results", `run-latency-${os.hostname()}-${report.date.replace(/[:.]/g, "-")}.json`));
+  fs.mkdirSync(path.dirname(out), { recursive: true });
+  fs.writeFileSync(out, JSON.stringify(report, null, 2));
+  console.log("results: " + out);
+}
+
+main().then(() => process.exit(0), err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
@@ -0,0 +1,36 @@
+// Frame times of the fallback terminal view while it fills up.
+//
+// Usage: npx electron bench/terminal-frames.js [lines] [linesPerFrame]
+//
+// Reports p50/p95/max frame time for the first and the last 10% of the run,
+// which should be about the same if rendering cost does not grow with output.
+const { app, BrowserWindow } = require("electron");
+const path = require("path");
+
+const LINES = parseInt(process.argv[2] || "150000", 10);
+const PER_FRAME = parseInt(process.argv[3] || "200", 10);
+
+function stats(samples) {
+  const s = samples.map(f => f.ms).sort((a, b) => a - b);
+  const at = p => +s[Math.min(s.length - 1, Math.floor(p * s.length))].toFixed(2);
+  return { frames: s.length, p50: at(0.5), p95: at(0.95), max: at(1) };
+}
+
+app.whenReady().then(async () => {
+  const win = new BrowserWindow({ width: 1000, height: 400, show: true });
+  await win.loadFile(path.join(__dirname, "terminal-frames.html"));
+  try {
+    const frames = await win.webContents.executeJavaScript(`runBench(${LINES}, ${PER_FRAME})`);
+    const tenth = Math.max(1, Math.floor(frames.length / 10));
+    console.log(JSON.stringify({
+      lines: LINES,
+      linesPerFrame: PER_FRAME,
+      first10pct: stats(frames.slice(1, tenth + 1)),
+      last10pct: stats(frames.slice(-tenth))
+    }));
+    app.exit(0);
+  } catch (err) {
+    console.error("Error: " + err.message);
+    app.exit(1);
+  }
+});
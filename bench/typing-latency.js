@@ -0,0 +1,71 @@
+// Typing latency in the editor on a 10k-line C++ file.
+//
+// Usage: npx electron bench/typing-latency.js [lines] [keystrokes]
+//
+// Starts the real app (main.js), loads a generated file into the editor, then
+// types one character at a time and measures keystroke -> next painted frame.
+const { app, BrowserWindow } = require("electron");
+
+const LINES = parseInt(process.argv[2] || "10000", 10);
+const KEYS = parseInt(process.argv[3] || "300", 10);
+
+function source(lines) {
+  const out = ["#include <cstdio>", ""];
+  for (let i = 0; out.length < lines - 2; i++) {
+    out.push(`int f${i}(int x) {`, `    for (int k = 0; k < ${i % 97}; ++k) x = (x * 31 + k) % 1000003;`, "    return x;", "}");
+  }
+  out.push("int main() { return f0(1); }", "");
+  return out.join("\n");
+}
+
+// runs in the renderer; `editor` is the page-level Monaco instance
+const probe = (text, keys) => new Promise(resolve => {
+  const wait = () => {
+    if (typeof editor === "undefined" || !editor) return setTimeout(wait, 50);
+    editor.setValue(text);
+    const model = editor.getModel();
+    editor.setPosition({ lineNumber: Math.floor(model.getLineCount() / 2), column: 1 });
+    editor.focus();
+    const samples = [];
+    let n = 0;
+    const step = () => {
+      if (n++ >= keys) return resolve(samples);
+      const t0 = performance.now();
+      editor.trigger("keyboard", "type", { text: n % 40 === 0 ? "\n" : "x" });
+      requestAnimationFrame(() => {
+        samples.push(performance.now() - t0);
+        setTimeout(step, 16);
+      });
+    };
+    // let initial tokenization/layout settle before measuring
+    setTimeout(step, 1000);
+  };
+  wait();
+});
+
+function pct(sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+}
+
+app.on("browser-window-created", (_, win) => {
+  win.webContents.once("did-finish-load", async () => {
+    try {
+      const samples = await win.webContents.executeJavaScript(`(${probe})(${JSON.stringify(source(LINES))}, ${KEYS})`);
+      const sorted = samples.slice().sort((a, b) => a - b);
+      const res = {
+        lines: LINES,
+        keystrokes: samples.length,
+        p50: +pct(sorted, 0.5).toFixed(2),
+        p95: +pct(sorted, 0.95).toFixed(2),
+        max: +sorted[sorted.length - 1].toFixed(2)
+      };
+      console.log(JSON.stringify(res));
+      app.exit(0);
+    } catch (err) {
+      console.error("Error: " + err.message);
+      app.exit(1);
+    }
+  });
+});
+
+require("../main.js");
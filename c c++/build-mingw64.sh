@@ -5,6 +5,7 @@
 # Built on Linux. Tested with Debian 12.10.0.
 # Installed build dependencies:
 # sudo apt install -y p7zip-full build-essential bison flex texinfo texlive texlive-plain-generic cmake licensecheck help2man gengetopt osslsigncode opensc pcscd
+# Optional for the PGO build of GCC (GCC_PGO_RUN='wine'): sudo apt install -y wine
 # Target distribution has the following directory structure:
 # bin                   # user applications (e.g. gcc)
 # i686-w64-mingw32      # x86 target directory
@@ -70,6 +71,10 @@ GCC_LANGS='c,c++,lto'
 GCC_HOST_CONFIG='--enable-seh-exceptions --with-arch=core2 --with-tune=generic --enable-threads=posix --disable-nls --disable-libstdcxx-verbose --disable-libstdcxx-pch --enable-clocale=generic --enable-shared=libstdc++ --enable-static --enable-libatomic --enable-fully-dynamic-string --enable-lto --enable-plugins --enable-libgomp --with-dwarf2 --disable-win32-registry --enable-version-specific-runtime-libs --enable-checking=release'
 GCC_TARGET_CONFIG='--enable-seh-exceptions --with-arch=core2 --with-tune=generic --enable-threads=posix --disable-nls --disable-libstdcxx-verbose --disable-libstdcxx-pch --enable-clocale=generic --enable-shared=libstdc++ --enable-static --enable-libatomic --enable-fully-dynamic-string --enable-lto --enable-plugins --enable-libgomp --with-dwarf2 --enable-mingw-wildcard=platform --disable-win32-registry --enable-version-specific-runtime-libs --enable-checking=release'
 MCRTDLL='ucrt' # default: msvcrt-os
+# optimized compiler executables (opt-in; empty to disable)
+GCC_LTO=''     # 'yes': link-time optimization of gcc's host programs (cc1, cc1plus, driver, ...)
+GCC_PGO_RUN='' # 'wine': runs the instrumented Windows compiler on this machine to collect PGO training data
+GCC_PGO_CORPUS="$(cd "$(dirname "${0}")/../bench/compile-corpus" 2>/dev/null && pwd)" # training programs (*.c, *.cpp)
 THREADS=$(nproc)
 LOG="${ROOT}/build-mingw64.log"
 
@@ -79,6 +84,20 @@ export CFLAGS='-std=gnu17 -O2 -march=core2 -mtune=generic -fno-ident -mstackreal
 export CXXFLAGS='-O2 -march=core2 -mtune=generic -fno-ident -mstackrealign -fomit-frame-pointer -fno-strict-aliasing -Wno-maybe-uninitialized'
 export LDFLAGS='-s -Wl,-no-undefined' # no debug symbols
 
+# flags added to CFLAGS/CXXFLAGS/LDFLAGS and archive tools for the final GCC host programs
+GCC_LTO_FLAGS=''
+GCC_LTO_TOOLS=''
+if [ -n "${GCC_LTO}" ]; then
+	GCC_LTO_FLAGS=" -flto=${THREADS}"
+	GCC_LTO_TOOLS='AR=x86_64-w64-mingw32-gcc-ar NM=x86_64-w64-mingw32-gcc-nm RANLIB=x86_64-w64-mingw32-gcc-ranlib'
+fi
+
+# PGO needs its runner; without it the PGO steps are skipped
+if [ -n "${GCC_PGO_RUN}" ] && ! command -v "${GCC_PGO_RUN%% *}" >/dev/null 2>&1; then
+	echo "GCC_PGO_RUN: ${GCC_PGO_RUN%% *} not found, building GCC without PGO."
+	GCC_PGO_RUN=''
+fi
+
 # commands
 alias rcp='cp'
 cp --help | grep -q reflink && alias rcp='cp --reflink=auto'
@@ -1940,16 +1959,85 @@ if step 'build OpenCL'; then
 	fi
 fi
 
+# configure the final GCC in the current build directory (a sibling of gcc-src);
+# extra arguments are passed to configure (host CFLAGS etc.)
+configure_final_gcc() {
+	"../gcc-src/configure" --host=x86_64-w64-mingw32 --target=x86_64-w64-mingw32 --disable-bootstrap --enable-targets=all "--enable-languages=${GCC_LANGS}" $GCC_TARGET_CONFIG "--enable-default-compressed-debug-sections-algorithm=${ZIP_OPT}" --disable-cloog-version-check --enable-cloog-backend=isl "--with-gmp=${HOST}/x86_64-w64-mingw32" "--with-mpfr=${HOST}/x86_64-w64-mingw32" "--with-mpc=${HOST}/x86_64-w64-mingw32" "--with-isl=${HOST}/x86_64-w64-mingw32" "--with-cloog=${HOST}/x86_64-w64-mingw32" "--with-system-zlib=${HOST}/x86_64-w64-mingw32" "${WITH_ZSTD}" "--prefix=${PREFIX}" "--libdir=${PREFIX}/x86_64-w64-mingw32/lib" "--libexecdir=${PREFIX}/x86_64-w64-mingw32/lib" "--with-native-system-header-dir=/x86_64-w64-mingw32/include" "$@" >>"${LOG}" 2>&1 || error "Failed to configure ${GCC}."
+	sed -i '/^FLAGS_FOR_TARGET =/s|mingw|i686-w64-mingw32|g' Makefile || error "Failed to patch Makefile."
+	sed -i '/^FLAGS_FOR_TARGET =/s|i686-w64-mingw32/lib |i686-w64-mingw32/lib -isystem ${prefix}/include |g' Makefile || error "Failed to patch Makefile."
+}
+
 if step "build final ${GCC}"; then
 	mkdir -p "${BUILD}/gcc" || error "Failed to create ${BUILD}/gcc."
 	cd "${BUILD}/gcc"
-	"../gcc-src/configure" --host=x86_64-w64-mingw32 --target=x86_64-w64-mingw32 --disable-bootstrap --enable-targets=all "--enable-languages=${GCC_LANGS}" $GCC_TARGET_CONFIG "--enable-default-compressed-debug-sections-algorithm=${ZIP_OPT}" --disable-cloog-version-check --enable-cloog-backend=isl "--with-gmp=${HOST}/x86_64-w64-mingw32" "--with-mpfr=${HOST}/x86_64-w64-mingw32" "--with-mpc=${HOST}/x86_64-w64-mingw32" "--with-isl=${HOST}/x86_64-w64-mingw32" "--with-cloog=${HOST}/x86_64-w64-mingw32" "--with-system-zlib=${HOST}/x86_64-w64-mingw32" "${WITH_ZSTD}" "--prefix=${PREFIX}" "--libdir=${PREFIX}/x86_64-w64-mingw32/lib" "--libexecdir=${PREFIX}/x86_64-w64-mingw32/lib" "--with-native-system-header-dir=/x86_64-w64-mingw32/include" >>"${LOG}" 2>&1 || error "Failed to configure ${GCC}."
-	sed -i '/^FLAGS_FOR_TARGET =/s|mingw|i686-w64-mingw32|g' Makefile || error "Failed to patch Makefile."
-	sed -i '/^FLAGS_FOR_TARGET =/s|i686-w64-mingw32/lib |i686-w64-mingw32/lib -isystem ${prefix}/include |g' Makefile || error "Failed to patch Makefile."
+	configure_final_gcc "CFLAGS=${CFLAGS}${GCC_LTO_FLAGS}" "CXXFLAGS=${CXXFLAGS}${GCC_LTO_FLAGS}" "LDFLAGS=${LDFLAGS}${GCC_LTO_FLAGS}" ${GCC_LTO_TOOLS}
 	make -j $THREADS >>"${LOG}" 2>&1 || error "Failed to build ${GCC}."
 	make install >>"${LOG}" 2>&1 || error "Failed to install ${GCC}."
 fi
 
+# PGO: the compiler proper is rebuilt from profiles of compiling ${GCC_PGO_CORPUS}.
+# Profile data is matched by object path, so both builds use ${BUILD}/gcc-pgo.
+# Only the gcc/ host programs are rebuilt (make all-gcc); the target libraries
+# from the step above are kept.
+PGO_DATA="${BUILD}/gcc-pgo-data"
+
+if step "build instrumented ${GCC} (PGO)"; then
+	if [ -n "${GCC_PGO_RUN}" ]; then
+		rm -rf "${BUILD}/gcc-pgo" "${PGO_DATA}"
+		mkdir -p "${BUILD}/gcc-pgo" "${PGO_DATA}" || error "Failed to create ${BUILD}/gcc-pgo."
+		cd "${BUILD}/gcc-pgo"
+		configure_final_gcc "CFLAGS=${CFLAGS} -fprofile-generate=${PGO_DATA}" "CXXFLAGS=${CXXFLAGS} -fprofile-generate=${PGO_DATA}" "LDFLAGS=${LDFLAGS} -fprofile-generate=${PGO_DATA}"
+		make -j $THREADS all-gcc >>"${LOG}" 2>&1 || error "Failed to build instrumented ${GCC}."
+	else
+		echo 'Skipped. Not configured.'
+	fi
+fi
+
+if step "train ${GCC} (PGO)"; then
+	if [ -n "${GCC_PGO_RUN}" ]; then
+		[ -n "${GCC_PGO_CORPUS}" ] && [ -d "${GCC_PGO_CORPUS}" ] || error "PGO training corpus not found (GCC_PGO_CORPUS)."
+		# installed toolchain with the instrumented cc1/cc1plus in place
+		PGO_ROOT="${BUILD}/gcc-pgo-root"
+		PGO_LIBEXEC="${PGO_ROOT}/x86_64-w64-mingw32/lib/gcc/x86_64-w64-mingw32/${GCC#gcc-}"
+		rm -rf "${PGO_ROOT}"
+		rcp -r "${PREFIX}" "${PGO_ROOT}" || error "Failed to copy ${PREFIX} to ${PGO_ROOT}."
+		install -m 755 "${BUILD}/gcc-pgo/gcc/cc1.exe" "${BUILD}/gcc-pgo/gcc/cc1plus.exe" "${PGO_LIBEXEC}/" || error "Failed to install instrumented cc1/cc1plus."
+		# the instrumented programs write to the absolute ${PGO_DATA}; under Wine that resolves
+		# through drive Z: as long as the working directory is on Z: (any Linux path)
+		cd "${BUILD}"
+		for f in "${GCC_PGO_CORPUS}"/*.c; do
+			for opt in '-O0 -g' '-O2'; do
+				${GCC_PGO_RUN} "${PGO_ROOT}/bin/gcc.exe" -std=c11 ${opt} -S -o "${BUILD}/gcc-pgo-train.s" "${f}" >>"${LOG}" 2>&1 || error "PGO training failed on ${f} (${opt})."
+			done
+		done
+		for f in "${GCC_PGO_CORPUS}"/*.cpp; do
+			for opt in '-std=c++17 -O0 -g' '-std=c++17 -O2' '-std=c++20 -O2'; do
+				${GCC_PGO_RUN} "${PGO_ROOT}/bin/g++.exe" ${opt} -S -o "${BUILD}/gcc-pgo-train.s" "${f}" >>"${LOG}" 2>&1 || error "PGO training failed on ${f} (${opt})."
+			done
+		done
+		rm -f "${BUILD}/gcc-pgo-train.s"
+		[ -n "$(find "${PGO_DATA}" -name '*.gcda' | head -n 1)" ] || error "PGO training wrote no profile data to ${PGO_DATA} (check GCC_PGO_RUN)."
+		rm -rf "${PGO_ROOT}"
+	else
+		echo 'Skipped. Not configured.'
+	fi
+fi
+
+if step "rebuild ${GCC} with profile data (PGO)"; then
+	if [ -n "${GCC_PGO_RUN}" ]; then
+		# code not reached by the corpus keeps normal -O2 optimization (-fprofile-partial-training)
+		PGO_USE="-fprofile-use=${PGO_DATA} -fprofile-partial-training -Wno-missing-profile"
+		rm -rf "${BUILD}/gcc-pgo"
+		mkdir -p "${BUILD}/gcc-pgo" || error "Failed to create ${BUILD}/gcc-pgo."
+		cd "${BUILD}/gcc-pgo"
+		configure_final_gcc "CFLAGS=${CFLAGS} ${PGO_USE}${GCC_LTO_FLAGS}" "CXXFLAGS=${CXXFLAGS} ${PGO_USE}${GCC_LTO_FLAGS}" "LDFLAGS=${LDFLAGS}${GCC_LTO_FLAGS}" ${GCC_LTO_TOOLS}
+		make -j $THREADS all-gcc >>"${LOG}" 2>&1 || error "Failed to build ${GCC} with profile data."
+		make install-gcc >>"${LOG}" 2>&1 || error "Failed to install ${GCC} built with profile data."
+	else
+		echo 'Skipped. Not configured.'
+	fi
+fi
+
 if step "final adjustments for ${GCC}"; then
 	# correct LTO plugin paths
 	cd "${PREFIX}/bin" && ln -s "../x86_64-w64-mingw32/lib/gcc/x86_64-w64-mingw32/${GCC#gcc-}/liblto_plugin.dll" "liblto_plugin.dll" || error "Failed to create link ${PREFIX}/i686-w64-mingw32/lib/bfd-plugins/liblto_plugin.dll."
@@ -1,14 +1,48 @@
 const path = require('path');
+const headermap = require('../lib/headermap');
+const install = require('../lib/install');
+
+const STD = ['-std=c11', '-O2'];
+
+// build profiles: flags added to the default compile line (opts.profile)
+const profiles = {
+  default: [],
+  // libgomp is linked statically from the bundled toolchain
+  openmp: ['-fopenmp'],
+  // -march for this machine's ISA level is added by main.js (lib/hostcpu.js)
+  host: []
+};
 
 module.exports = {
   filename: "main.c",
-  compile: file => {
+  profiles,
+  // opts.profile: key of `profiles`, opts.march: -march value, opts.flags: extra compiler flags,
+  // opts.out: output exe (default main.exe)
+  compile: (file, opts = {}) => {
     const binDir = path.dirname(file);
-    const compiler = path.join(__dirname, '..', 'c c++', 'bin', 'gcc.exe');
-    const out = path.join(binDir, 'main.exe');
+    const compiler = path.join(install.dir('toolchain'), 'bin', 'gcc.exe');
+    const out = opts.out || path.join(binDir, 'main.exe');
+    const extra = (profiles[opts.profile] || []).concat(opts.march ? ['-march=' + opts.march] : [], opts.flags || []);
+    const flags = extra.length ? ' ' + extra.join(' ') : '';
+    // header resolution map (scripts/build-header-map.js), when installed
+    const map = headermap.flags('c', extra);
+    const include = map.length ? ` ${map[0]} "${map[1]}"` : '';
     // compile only
-    return `"${compiler}" -std=c11 -O2 -o "${out}" "${file}"`;
+    return `"${compiler}"${include} ${STD.join(' ')}${flags} -o "${out}" "${file}"`;
+  },
+
+  // remote compile (lib/remote-compile.js): the flags that translate the
+  // preprocessed source, and the local link of the object that comes back.
+  // The server builds for this machine's CPU (opts.isa), never its own.
+  compileFlags: (opts = {}) => STD.concat(profiles[opts.profile] || [], opts.isa || opts.march ? ['-march=' + (opts.isa || opts.march)] : []),
+  link: (objects, opts = {}) => {
+    const compiler = path.join(install.dir('toolchain'), 'bin', 'gcc.exe');
+    const out = opts.out || path.join(path.dirname(objects[0]), 'main.exe');
+    const extra = (profiles[opts.profile] || []).concat(opts.flags || []);
+    return `"${compiler}"${extra.length ? ' ' + extra.join(' ') : ''} -o "${out}" ${objects.map(o => `"${o}"`).join(' ')}`;
   },
+  // program + args for spawning the result directly (no shell)
+  argv: file => [path.join(path.dirname(file), 'main.exe')],
   runCommand: file => {
     const binDir = path.dirname(file);
     const out = path.join(binDir, 'main.exe');
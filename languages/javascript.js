@@ -1,10 +1,13 @@
 const path = require('path');
+const install = require('../lib/install');
 
 module.exports = {
   filename: "main.js",
   run: file => {
     // Use local QuickJS binary to run JS files. Return a PowerShell-safe invocation.
-    const exe = path.join(__dirname, '..', 'quickjs', 'qjs.exe');
+    const exe = path.join(install.dir('quickjs'), 'qjs.exe');
     return `& "${exe}" "${file}"`;
-  }
+  },
+  // program + args for spawning directly (no shell)
+  argv: file => [path.join(install.dir('quickjs'), 'qjs.exe'), file]
 };
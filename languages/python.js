@@ -1,10 +1,13 @@
 const path = require('path');
+const install = require('../lib/install');
 
 module.exports = {
   filename: "main.py",
   run: file => {
     // Use local Python launcher (py.exe) from the bundled `py` folder.
-    const exe = path.join(__dirname, '..', 'py', 'py.exe');
+    const exe = path.join(install.dir('python'), 'py.exe');
     return `& "${exe}" "${file}"`;
-  }
+  },
+  // program + args for spawning directly (no shell)
+  argv: file => [path.join(install.dir('python'), 'py.exe'), file]
 };
@@ -0,0 +1,162 @@
+// "Benchmark" action: run a program W + N times through lib/benchrun.c (built
+// on first use with the bundled gcc), summarise wall time, CPU time and peak
+// RSS, and keep a per-file history so two versions can be compared.
+const { execFile } = require("child_process");
+const crypto = require("crypto");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const install = require("./install");
+
+const gcc = () => path.join(install.dir("toolchain"), "bin", "gcc.exe");
+const RUNNER_SRC = path.join(__dirname, "benchrun.c");
+const HISTORY_LIMIT = 50;
+
+function run(exe, args, opts = {}) {
+  return new Promise((resolve, reject) => {
+    execFile(exe, args, { maxBuffer: 16 * 1024 * 1024, windowsHide: true, ...opts }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve(out);
+    });
+  });
+}
+
+// (re)build the runner when its source is newer than the binary
+async function runner(dir) {
+  const exe = path.join(dir, process.platform === "win32" ? "benchrun.exe" : "benchrun");
+  const stale = !fs.existsSync(exe) || fs.statSync(exe).mtimeMs < fs.statSync(RUNNER_SRC).mtimeMs;
+  if (stale) {
+    const libs = process.platform === "win32" ? ["-lpsapi"] : [];
+    await run(gcc(), ["-O2", "-o", exe, RUNNER_SRC, ...libs]);
+  }
+  return exe;
+}
+
+const median = v => {
+  const s = v.slice().sort((a, b) => a - b);
+  const m = s.length >> 1;
+  return s.length % 2 ? s[m] : (s[m - 1] + s[m]) / 2;
+};
+
+// median, MAD (median absolute deviation), min, max, mean
+function stats(values) {
+  if (!values.length) return null;
+  const med = median(values);
+  const round = x => +x.toFixed(3);
+  return {
+    median: round(med),
+    mad: round(median(values.map(v => Math.abs(v - med)))),
+    min: round(Math.min(...values)),
+    max: round(Math.max(...values)),
+    mean: round(values.reduce((a, b) => a + b, 0) / values.length)
+  };
+}
+
+function parseRuns(text) {
+  const runs = [];
+  for (const line of text.split(/\r?\n/)) {
+    const m = /^(warmup|run) (\d+) (.*)$/.exec(line);
+    if (!m) continue;
+    const r = { warmup: m[1] === "warmup", index: +m[2] };
+    for (const [, k, v] of m[3].matchAll(/(\w+)=(-?\d+)/g)) r[k] = +v;
+    runs.push({
+      warmup: r.warmup,
+      wallMs: r.wall_us / 1000,
+      cpuMs: (r.user_us + r.sys_us) / 1000,
+      userMs: r.user_us / 1000,
+      sysMs: r.sys_us / 1000,
+      rssKB: r.rss_kb,
+      exit: r.exit
+    });
+  }
+  return runs;
+}
+
+// pin to the last logical CPU: on most systems the OS keeps it quietest
+function defaultCpu() {
+  const n = os.cpus().length;
+  return n > 1 ? n - 1 : -1;
+}
+
+// Run argv `warmup` + `runs` times. Returns { runs, wall, cpu, rssKB, exit, cpuPinned }.
+// `env` is added to the program's environment (the runner passes it on).
+async function measure(dir, argv, { warmup = 2, runs = 10, cpu = defaultCpu(), timeoutMs = 600_000, env = null } = {}) {
+  const exe = await runner(dir);
+  const out = await run(exe, [String(warmup), String(runs), String(cpu), ...argv],
+    { cwd: dir, timeout: timeoutMs, env: env ? { ...process.env, ...env } : process.env });
+  const all = parseRuns(out);
+  const measured = all.filter(r => !r.warmup);
+  if (!measured.length) throw new Error("benchmark produced no runs");
+  const failed = measured.find(r => r.exit !== 0);
+  return {
+    runs: all,
+    wall: stats(measured.map(r => r.wallMs)),
+    cpu: stats(measured.map(r => r.cpuMs)),
+    rssKB: Math.max(...measured.map(r => r.rssKB)),
+    exit: failed ? failed.exit : 0,
+    cpuPinned: cpu
+  };
+}
+
+// 1, 2, 4, ... up to maxThreads (always including maxThreads itself)
+function threadCounts(maxThreads) {
+  const counts = [];
+  for (let n = 1; n < maxThreads; n *= 2) counts.push(n);
+  counts.push(maxThreads);
+  return counts;
+}
+
+// OpenMP strong scaling: the same program at each thread count (OMP_NUM_THREADS),
+// unpinned so the threads can spread over the cores. Speedup and efficiency are
+// relative to the 1-thread median. onPoint(point) after each thread count.
+async function scaling(dir, argv, { maxThreads = os.cpus().length, warmup = 1, runs = 5 } = {}, onPoint = () => {}) {
+  const points = [];
+  for (const threads of threadCounts(maxThreads)) {
+    const r = await measure(dir, argv, { warmup, runs, cpu: -1, env: { OMP_NUM_THREADS: String(threads), OMP_PROC_BIND: "spread" } });
+    if (r.exit) throw new Error(`program exited with code ${r.exit} at ${threads} threads`);
+    const base = points.length ? points[0].wall.median : r.wall.median;
+    const speedup = base / r.wall.median;
+    const point = { threads, wall: r.wall, cpu: r.cpu, speedup: +speedup.toFixed(3), efficiency: +(speedup / threads).toFixed(3) };
+    points.push(point);
+    onPoint(point);
+  }
+  return points;
+}
+
+// per-file result history, newest last: { [key]: [entry] }
+class History {
+  constructor(file) {
+    this.file = file;
+    try {
+      this.data = JSON.parse(fs.readFileSync(file, "utf8"));
+    } catch (_) {
+      this.data = {};
+    }
+  }
+
+  list(key) {
+    return this.data[key] || [];
+  }
+
+  add(key, code, result) {
+    const entry = {
+      date: new Date().toISOString(),
+      codeHash: crypto.createHash("sha1").update(code).digest("hex").slice(0, 10),
+      warmup: result.runs.filter(r => r.warmup).length,
+      runs: result.runs.filter(r => !r.warmup).length,
+      wall: result.wall,
+      cpu: result.cpu,
+      rssKB: result.rssKB
+    };
+    const list = (this.data[key] = this.list(key).concat(entry).slice(-HISTORY_LIMIT));
+    fs.writeFileSync(this.file, JSON.stringify(this.data, null, 1));
+    return list;
+  }
+
+  clear(key) {
+    delete this.data[key];
+    fs.writeFileSync(this.file, JSON.stringify(this.data, null, 1));
+  }
+}
+
+module.exports = { runner, measure, scaling, threadCounts, stats, parseRuns, History };
@@ -0,0 +1,283 @@
+/*
+ * Program runner for the "Benchmark" action (lib/bench.js) and the test
+ * runner (lib/testrun.js), built on first use with the bundled gcc.
+ *
+ * Benchmark mode runs a program W + N times back to back, pinned to one CPU,
+ * with stdin/stdout/stderr on the null device, and prints one line per run:
+ *
+ *   warmup|run <i> wall_us=<> user_us=<> sys_us=<> rss_kb=<> exit=<>
+ *
+ * Limit mode (--run) runs it once with the runner's own stdio, killing it
+ * after <time_ms> and capping its memory at <mem_mb> (job object on Windows,
+ * RLIMIT_AS elsewhere; 0 = no limit). The stats line, with limit=time|memory
+ * when one was hit, goes to <stats file> so stdout stays the program's.
+ *
+ * usage: benchrun <warmup> <runs> <cpu or -1> <program> [args...]
+ *        benchrun --run <stats file> <time_ms> <mem_mb> <program> [args...]
+ */
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+
+/* CommandLineToArgvW-compatible quoting */
+static void append_arg(char *cmd, size_t size, const char *arg)
+{
+	size_t n = strlen(cmd), slashes = 0;
+	const char *p;
+	if (n && n < size - 1) cmd[n++] = ' ';
+	if (n < size - 1) cmd[n++] = '"';
+	for (p = arg; *p && n < size - 4; p++) {
+		if (*p == '\\') { slashes++; cmd[n++] = '\\'; continue; }
+		if (*p == '"') { while (slashes--) cmd[n++] = '\\'; cmd[n++] = '\\'; }
+		slashes = 0;
+		cmd[n++] = *p;
+	}
+	while (slashes-- && n < size - 2) cmd[n++] = '\\';
+	cmd[n++] = '"';
+	cmd[n] = 0;
+}
+
+static ULONGLONG filetime_us(FILETIME ft)
+{
+	return (((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime) / 10;
+}
+
+static int run_once(char *cmd, int cpu, const char *label, int index)
+{
+	STARTUPINFOA si;
+	PROCESS_INFORMATION pi;
+	SECURITY_ATTRIBUTES sa = { sizeof sa, NULL, TRUE };
+	HANDLE null_in = CreateFileA("NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, NULL);
+	HANDLE null_out = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, NULL);
+	LARGE_INTEGER freq, t0, t1;
+	FILETIME created, exited, kernel, user;
+	PROCESS_MEMORY_COUNTERS mem;
+	DWORD code = (DWORD)-1;
+
+	memset(&si, 0, sizeof si);
+	si.cb = sizeof si;
+	si.dwFlags = STARTF_USESTDHANDLES;
+	si.hStdInput = null_in;
+	si.hStdOutput = si.hStdError = null_out;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t0);
+	if (!CreateProcessA(NULL, cmd, NULL, NULL, TRUE, CREATE_SUSPENDED | CREATE_NO_WINDOW | ABOVE_NORMAL_PRIORITY_CLASS, NULL, NULL, &si, &pi)) {
+		fprintf(stderr, "cannot start program (error %lu)\n", GetLastError());
+		return -1;
+	}
+	if (cpu >= 0) SetProcessAffinityMask(pi.hProcess, (DWORD_PTR)1 << cpu);
+	ResumeThread(pi.hThread);
+	WaitForSingleObject(pi.hProcess, INFINITE);
+	QueryPerformanceCounter(&t1);
+	GetExitCodeProcess(pi.hProcess, &code);
+	GetProcessTimes(pi.hProcess, &created, &exited, &kernel, &user);
+	memset(&mem, 0, sizeof mem);
+	GetProcessMemoryInfo(pi.hProcess, &mem, sizeof mem);
+	printf("%s %d wall_us=%lld user_us=%llu sys_us=%llu rss_kb=%llu exit=%ld\n", label, index,
+	       (long long)((t1.QuadPart - t0.QuadPart) * 1000000 / freq.QuadPart),
+	       filetime_us(user), filetime_us(kernel), (unsigned long long)(mem.PeakWorkingSetSize / 1024), (long)code);
+	fflush(stdout);
+	CloseHandle(pi.hThread);
+	CloseHandle(pi.hProcess);
+	CloseHandle(null_in);
+	CloseHandle(null_out);
+	return 0;
+}
+
+static int run_limited(char *cmd, const char *stats, DWORD time_ms, SIZE_T mem_mb)
+{
+	STARTUPINFOA si;
+	PROCESS_INFORMATION pi;
+	HANDLE job = CreateJobObjectA(NULL, NULL);
+	JOBOBJECT_EXTENDED_LIMIT_INFORMATION lim;
+	LARGE_INTEGER freq, t0, t1;
+	FILETIME created, exited, kernel, user;
+	DWORD code = (DWORD)-1, wait;
+	const char *hit = "";
+	FILE *f;
+
+	memset(&lim, 0, sizeof lim);
+	lim.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+	if (mem_mb) {
+		lim.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PROCESS_MEMORY;
+		lim.ProcessMemoryLimit = mem_mb << 20;
+	}
+	SetInformationJobObject(job, JobObjectExtendedLimitInformation, &lim, sizeof lim);
+
+	memset(&si, 0, sizeof si);
+	si.cb = sizeof si;
+	si.dwFlags = STARTF_USESTDHANDLES;
+	si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+	si.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+	si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t0);
+	if (!CreateProcessA(NULL, cmd, NULL, NULL, TRUE, CREATE_SUSPENDED | CREATE_NO_WINDOW, NULL, NULL, &si, &pi)) {
+		fprintf(stderr, "cannot start program (error %lu)\n", GetLastError());
+		return 1;
+	}
+	AssignProcessToJobObject(job, pi.hProcess);
+	ResumeThread(pi.hThread);
+	wait = WaitForSingleObject(pi.hProcess, time_ms ? time_ms : INFINITE);
+	if (wait == WAIT_TIMEOUT) {
+		TerminateJobObject(job, 1);
+		WaitForSingleObject(pi.hProcess, INFINITE);
+		hit = "time";
+	}
+	QueryPerformanceCounter(&t1);
+	GetExitCodeProcess(pi.hProcess, &code);
+	GetProcessTimes(pi.hProcess, &created, &exited, &kernel, &user);
+	QueryInformationJobObject(job, JobObjectExtendedLimitInformation, &lim, sizeof lim, NULL);
+	if (!*hit && mem_mb && lim.PeakProcessMemoryUsed + (1 << 20) >= (mem_mb << 20) && code != 0) hit = "memory";
+	f = fopen(stats, "w");
+	if (f) {
+		fprintf(f, "run 0 wall_us=%lld user_us=%llu sys_us=%llu rss_kb=%llu exit=%ld limit=%s\n",
+		        (long long)((t1.QuadPart - t0.QuadPart) * 1000000 / freq.QuadPart),
+		        filetime_us(user), filetime_us(kernel), (unsigned long long)(lim.PeakProcessMemoryUsed / 1024), (long)code, hit);
+		fclose(f);
+	}
+	CloseHandle(pi.hThread);
+	CloseHandle(pi.hProcess);
+	CloseHandle(job);
+	return 0;
+}
+
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static int run_once(char **argv, int cpu, const char *label, int index)
+{
+	struct timespec t0, t1;
+	struct rusage ru;
+	int status = 0;
+	pid_t pid;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	pid = fork();
+	if (pid < 0) return -1;
+	if (pid == 0) {
+		int fd = open("/dev/null", O_RDWR);
+		if (cpu >= 0) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			sched_setaffinity(0, sizeof set, &set);
+		}
+		dup2(fd, 0);
+		dup2(fd, 1);
+		dup2(fd, 2);
+		execvp(argv[0], argv);
+		_exit(127);
+	}
+	wait4(pid, &status, 0, &ru);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	printf("%s %d wall_us=%lld user_us=%lld sys_us=%lld rss_kb=%ld exit=%d\n", label, index,
+	       (long long)(t1.tv_sec - t0.tv_sec) * 1000000 + (t1.tv_nsec - t0.tv_nsec) / 1000,
+	       (long long)ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec,
+	       (long long)ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec,
+	       ru.ru_maxrss, WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status));
+	fflush(stdout);
+	return 0;
+}
+
+static int run_limited(char **argv, const char *stats, long time_ms, long mem_mb)
+{
+	struct timespec t0, t1, tick = { 0, 1000000 };
+	struct rusage ru;
+	int status = 0;
+	const char *hit = "";
+	long long wall_us;
+	pid_t pid;
+	FILE *f;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	pid = fork();
+	if (pid < 0) return 1;
+	if (pid == 0) {
+		/* own process group: the time limit also ends its children (cc1plus under gcc) */
+		setpgid(0, 0);
+		if (mem_mb) {
+			struct rlimit rl;
+			rl.rlim_cur = rl.rlim_max = (rlim_t)mem_mb << 20;
+			setrlimit(RLIMIT_AS, &rl);
+		}
+		execvp(argv[0], argv);
+		_exit(127);
+	}
+	for (;;) {
+		pid_t r = wait4(pid, &status, WNOHANG, &ru);
+		if (r == pid || (r < 0 && errno != EINTR)) break;
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		if (time_ms && (t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000 >= time_ms) {
+			kill(-pid, SIGKILL);
+			wait4(pid, &status, 0, &ru);
+			hit = "time";
+			break;
+		}
+		nanosleep(&tick, NULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	wall_us = (long long)(t1.tv_sec - t0.tv_sec) * 1000000 + (t1.tv_nsec - t0.tv_nsec) / 1000;
+	/* RLIMIT_AS failures only show up as failed allocations: the caller
+	   recognises them from the program's stderr */
+	f = fopen(stats, "w");
+	if (f) {
+		fprintf(f, "run 0 wall_us=%lld user_us=%lld sys_us=%lld rss_kb=%ld exit=%d limit=%s\n", wall_us,
+		        (long long)ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec,
+		        (long long)ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec,
+		        ru.ru_maxrss, WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status), hit);
+		fclose(f);
+	}
+	return 0;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+	int warmup, runs, cpu, i;
+	if (argc < 5 || (!strcmp(argv[1], "--run") && argc < 6)) {
+		fprintf(stderr, "usage: benchrun <warmup> <runs> <cpu or -1> <program> [args...]\n"
+		                "       benchrun --run <stats file> <time_ms> <mem_mb> <program> [args...]\n");
+		return 2;
+	}
+	if (!strcmp(argv[1], "--run")) {
+#ifdef _WIN32
+		static char cmd[32768];
+		cmd[0] = 0;
+		for (i = 5; i < argc; i++) append_arg(cmd, sizeof cmd, argv[i]);
+		return run_limited(cmd, argv[2], (DWORD)atol(argv[3]), (SIZE_T)atol(argv[4]));
+#else
+		return run_limited(argv + 5, argv[2], atol(argv[3]), atol(argv[4]));
+#endif
+	}
+	warmup = atoi(argv[1]);
+	runs = atoi(argv[2]);
+	cpu = atoi(argv[3]);
+#ifdef _WIN32
+	{
+		static char cmd[32768];
+		cmd[0] = 0;
+		for (i = 4; i < argc; i++) append_arg(cmd, sizeof cmd, argv[i]);
+		for (i = 0; i < warmup; i++) if (run_once(cmd, cpu, "warmup", i) < 0) return 1;
+		for (i = 0; i < runs; i++) if (run_once(cmd, cpu, "run", i) < 0) return 1;
+	}
+#else
+	for (i = 0; i < warmup; i++) if (run_once(argv + 4, cpu, "warmup", i) < 0) return 1;
+	for (i = 0; i < runs; i++) if (run_once(argv + 4, cpu, "run", i) < 0) return 1;
+#endif
+	return 0;
+}
@@ -0,0 +1,351 @@
+// Compile cache for the run-code C/C++ path, in two tiers.
+//
+// CompileCache (per machine): the key covers everything that changes the
+// output: the source, the full compile command (compiler, flags, profile),
+// the toolchain build and the ISA level the code is compiled for. Entries
+// are <key>.exe files; the least recently used go once the directory is over
+// `maxBytes`.
+//
+// SharedCache (optional, lab-wide) is consulted on a local miss. Its store is
+// a directory on the lab server (DirStore) or an HTTP stand-in for one
+// (HttpStore, scripts/compile-cache-server.js). Its key must not depend on
+// anyone's temp paths, so it covers the preprocessed source, the compile
+// flags with paths replaced by placeholders, a hash of the toolchain and the
+// ISA level. The store is size-capped LRU as well, and every seat publishes
+// its hit counts there for the teacher view.
+//
+// Seats only read the shared tier: whatever is in it runs on every seat, so
+// it is filled by the teacher machine or a build server only. A DirStore is
+// written only when opened with `writable` (the share itself must be
+// read-only for students), an HttpStore only with the server's upload `token`.
+// Read-only seats of a DirStore therefore publish no counters and do not
+// touch entries for LRU (eviction goes by upload time); the HTTP server takes
+// both from every seat.
+const crypto = require("crypto");
+const fs = require("fs");
+const http = require("http");
+const https = require("https");
+const os = require("os");
+const path = require("path");
+const stream = require("stream");
+
+const MB = 1024 * 1024;
+
+const hash = (fields, parts) => {
+  const h = crypto.createHash("sha256");
+  for (const k of fields) h.update(k + "\0" + String(parts[k] || "") + "\0");
+  return h.digest("hex").slice(0, 32);
+};
+
+// delete the oldest (by mtime) of `entries` [{ file, size, mtime }] beyond maxBytes
+function evict(entries, maxBytes, also = () => []) {
+  let total = 0;
+  for (const e of entries.sort((a, b) => b.mtime - a.mtime)) {
+    total += e.size;
+    if (total <= maxBytes) continue;
+    for (const f of [e.file, ...also(e.file)]) fs.rm(f, { force: true }, () => {});
+  }
+}
+
+class CompileCache {
+  constructor(dir, { maxBytes = 256 * MB } = {}) {
+    this.dir = dir;
+    this.maxBytes = maxBytes;
+    this.hits = 0;
+    this.misses = 0;
+  }
+
+  // parts: { code, command, toolchain, isa }
+  key(parts) {
+    return hash(["code", "command", "toolchain", "isa"], parts);
+  }
+
+  file(key) {
+    return path.join(this.dir, key + ".exe");
+  }
+
+  // copy a cached exe to `out`; false on a miss
+  get(key, out) {
+    const file = this.file(key);
+    try {
+      fs.copyFileSync(file, out);
+      const now = new Date();
+      fs.utimesSync(file, now, now); // keep recently used entries
+      this.hits++;
+      return true;
+    } catch (_) {
+      this.misses++;
+      return false;
+    }
+  }
+
+  put(key, exe) {
+    fs.mkdirSync(this.dir, { recursive: true });
+    const tmp = this.file(key) + ".tmp";
+    fs.copyFileSync(exe, tmp);
+    fs.renameSync(tmp, this.file(key));
+    this.trim();
+  }
+
+  entries() {
+    return fs.readdirSync(this.dir).filter(f => f.endsWith(".exe")).map(f => {
+      const st = fs.statSync(path.join(this.dir, f));
+      return { file: path.join(this.dir, f), size: st.size, mtime: st.mtimeMs };
+    });
+  }
+
+  trim() {
+    evict(this.entries(), this.maxBytes);
+  }
+
+  stats() {
+    let entries = [];
+    try { entries = this.entries(); } catch (_) {}
+    return { hits: this.hits, misses: this.misses, entries: entries.length, bytes: entries.reduce((n, e) => n + e.size, 0), maxBytes: this.maxBytes };
+  }
+}
+
+// Shared store in a directory (lab file share): <xx>/<key>.exe with a
+// <key>.json sidecar ({ ms } = compile time saved by a hit), per-seat
+// counters in stats/<seat>.json. Writes go through a temp name and rename, so
+// seats racing on the same key are harmless.
+class DirStore {
+  constructor(dir, { maxBytes = 4096 * MB, writable = false } = {}) {
+    this.dir = dir;
+    this.maxBytes = maxBytes;
+    this.writable = writable;
+    this.sharesStats = writable; // stats/<seat>.json lives in the share
+    this.lastTrim = 0;
+  }
+
+  file(key) {
+    return path.join(this.dir, key.slice(0, 2), key + ".exe");
+  }
+
+  // copy the entry to `out`; its metadata, or null on a miss
+  async get(key, out) {
+    const file = this.file(key);
+    try {
+      await fs.promises.copyFile(file, out);
+    } catch (_) {
+      return null;
+    }
+    if (this.writable) {
+      const now = new Date();
+      fs.promises.utimes(file, now, now).catch(() => {});
+    }
+    try {
+      return JSON.parse(await fs.promises.readFile(file.replace(/\.exe$/, ".json"), "utf8"));
+    } catch (_) {
+      return {};
+    }
+  }
+
+  async put(key, exe, meta = {}) {
+    const file = this.file(key);
+    const tmp = `${file}.${os.hostname()}-${process.pid}.tmp`;
+    await fs.promises.mkdir(path.dirname(file), { recursive: true });
+    await fs.promises.writeFile(file.replace(/\.exe$/, ".json"), JSON.stringify(meta));
+    await fs.promises.copyFile(exe, tmp);
+    await fs.promises.rename(tmp, file);
+    // every seat trims, but at most every few minutes
+    if (Date.now() - this.lastTrim > 5 * 60_000) {
+      this.lastTrim = Date.now();
+      evict(await this.entries(), this.maxBytes, f => [f.replace(/\.exe$/, ".json")]);
+    }
+  }
+
+  async entries() {
+    const out = [];
+    for (const sub of await fs.promises.readdir(this.dir).catch(() => [])) {
+      if (!/^[0-9a-f]{2}$/.test(sub)) continue;
+      for (const f of await fs.promises.readdir(path.join(this.dir, sub)).catch(() => [])) {
+        if (!f.endsWith(".exe")) continue;
+        const file = path.join(this.dir, sub, f);
+        const st = await fs.promises.stat(file).catch(() => null);
+        if (st) out.push({ file, size: st.size, mtime: st.mtimeMs });
+      }
+    }
+    return out;
+  }
+
+  async report(seat, counters) {
+    await fs.promises.mkdir(path.join(this.dir, "stats"), { recursive: true });
+    await fs.promises.writeFile(path.join(this.dir, "stats", seat.replace(/[^\w.-]/g, "_") + ".json"), JSON.stringify({ seat, ...counters, updated: Date.now() }));
+  }
+
+  // { seats: [{ seat, hits, misses, puts, errors, savedMs, updated }], entries, bytes, maxBytes }
+  async labStats() {
+    const dir = path.join(this.dir, "stats");
+    const seats = [];
+    for (const f of await fs.promises.readdir(dir).catch(() => [])) {
+      try { seats.push(JSON.parse(await fs.promises.readFile(path.join(dir, f), "utf8"))); } catch (_) {}
+    }
+    const entries = await this.entries();
+    return { seats, entries: entries.length, bytes: entries.reduce((n, e) => n + e.size, 0), maxBytes: this.maxBytes };
+  }
+}
+
+// The same store behind scripts/compile-cache-server.js:
+//   GET/PUT /<key> (X-Compile-Ms carries the metadata; PUT needs the token),
+//   PUT /stats/<seat>, GET /stats
+class HttpStore {
+  constructor(url, { timeoutMs = 3000, downloadMs = 30_000, token = null } = {}) {
+    this.url = url.replace(/\/+$/, "");
+    this.token = token;
+    this.writable = !!token;
+    this.sharesStats = true;
+    this.timeoutMs = timeoutMs;   // connect / idle
+    this.downloadMs = downloadMs; // a whole entry
+  }
+
+  request(method, p, body, onResponse) {
+    const mod = this.url.startsWith("https:") ? https : http;
+    return new Promise((resolve, reject) => {
+      const req = mod.request(this.url + p, { method, timeout: this.timeoutMs, headers: body && body.headers }, res => {
+        Promise.resolve(onResponse(res)).then(resolve, reject);
+      });
+      req.on("timeout", () => req.destroy(new Error(`compile cache server timed out after ${this.timeoutMs} ms`)));
+      req.on("error", reject);
+      if (body && body.file) fs.createReadStream(body.file).on("error", reject).pipe(req);
+      else req.end(body && body.data);
+    });
+  }
+
+  static text(res) {
+    return new Promise((resolve, reject) => {
+      let s = "";
+      res.setEncoding("utf8");
+      res.on("data", d => (s += d));
+      res.on("end", () => (res.statusCode < 300 ? resolve(s) : reject(new Error(`compile cache server: HTTP ${res.statusCode} ${s.trim()}`))));
+      res.on("error", reject);
+    });
+  }
+
+  get(key, out) {
+    return this.request("GET", "/" + key, null, res => {
+      if (res.statusCode === 404) {
+        res.resume();
+        return null;
+      }
+      if (res.statusCode !== 200) return HttpStore.text(res);
+      return this.download(res, out);
+    });
+  }
+
+  // The body into `out` through a temp file. A transfer that breaks off, is
+  // shorter than its Content-Length or takes longer than `downloadMs` is a
+  // miss, and leaves nothing behind.
+  download(res, out) {
+    const tmp = `${out}.${process.pid}.download`;
+    const expected = res.headers["content-length"] === undefined ? -1 : +res.headers["content-length"];
+    let received = 0;
+    res.on("data", c => (received += c.length));
+    const timer = setTimeout(() => res.destroy(), this.downloadMs);
+    return stream.promises.pipeline(res, fs.createWriteStream(tmp)).then(() => {
+      if (expected >= 0 && received !== expected) throw new Error(`download cut off at ${received} of ${expected} bytes`);
+      fs.renameSync(tmp, out);
+      return { ms: +res.headers["x-compile-ms"] || 0 };
+    }).catch(async () => {
+      await fs.promises.rm(tmp, { force: true });
+      return null;
+    }).finally(() => clearTimeout(timer));
+  }
+
+  put(key, exe, meta = {}) {
+    const headers = { "Content-Length": fs.statSync(exe).size, "X-Compile-Ms": String(Math.round(meta.ms || 0)), Authorization: "Bearer " + this.token };
+    return this.request("PUT", "/" + key, { file: exe, headers }, HttpStore.text);
+  }
+
+  report(seat, counters) {
+    const data = JSON.stringify(counters);
+    return this.request("PUT", "/stats/" + encodeURIComponent(seat), { data, headers: { "Content-Type": "application/json" } }, HttpStore.text);
+  }
+
+  async labStats() {
+    return JSON.parse(await this.request("GET", "/stats", null, HttpStore.text));
+  }
+}
+
+// Lab-wide tier. Every failure of the store counts as a miss (the lab server
+// being away must never break a build). The seat's counters are kept in
+// `statsFile` across sessions and published to the store a few seconds
+// after they change.
+class SharedCache {
+  constructor(store, { seat = `${os.hostname()}-${os.userInfo().username}`, statsFile } = {}) {
+    this.store = store;
+    this.seat = seat;
+    this.statsFile = statsFile;
+    this.counters = { hits: 0, misses: 0, puts: 0, errors: 0, savedMs: 0 };
+    try { Object.assign(this.counters, JSON.parse(fs.readFileSync(statsFile, "utf8"))); } catch (_) {}
+    this.lastError = null;
+    this.publishTimer = null;
+  }
+
+  static open(location, opts = {}) {
+    if (!location) return null;
+    const store = /^https?:\/\//.test(location) ? new HttpStore(location, opts) : new DirStore(location, opts);
+    return new SharedCache(store, opts);
+  }
+
+  // parts: { source (preprocessed), flags (path-free), toolchain, isa }
+  key(parts) {
+    return hash(["source", "flags", "toolchain", "isa"], parts);
+  }
+
+  async get(key, out) {
+    try {
+      const meta = await this.store.get(key, out);
+      if (meta) {
+        this.counters.hits++;
+        this.counters.savedMs += meta.ms || 0;
+      } else {
+        this.counters.misses++;
+      }
+      return meta;
+    } catch (err) {
+      this.failed(err);
+      return null;
+    } finally {
+      this.schedulePublish();
+    }
+  }
+
+  // a no-op on a read-only seat
+  async put(key, exe, meta) {
+    if (!this.store.writable) return;
+    try {
+      await this.store.put(key, exe, meta);
+      this.counters.puts++;
+    } catch (err) {
+      this.failed(err);
+    }
+    this.schedulePublish();
+  }
+
+  failed(err) {
+    this.counters.errors++;
+    this.lastError = err.message;
+  }
+
+  schedulePublish() {
+    if (this.publishTimer) return;
+    this.publishTimer = setTimeout(() => {
+      this.publishTimer = null;
+      if (this.statsFile) fs.promises.writeFile(this.statsFile, JSON.stringify(this.counters)).catch(() => {});
+      if (this.store.sharesStats) this.store.report(this.seat, this.counters).catch(err => this.failed(err));
+    }, 5000);
+    this.publishTimer.unref();
+  }
+
+  async stats() {
+    const own = { seat: this.seat, ...this.counters, writable: this.store.writable, sharesStats: this.store.sharesStats, lastError: this.lastError };
+    try {
+      return { own, lab: await this.store.labStats() };
+    } catch (err) {
+      return { own, error: err.message };
+    }
+  }
+}
+
+module.exports = { CompileCache, SharedCache, DirStore, HttpStore, MB };
@@ -0,0 +1,216 @@
+// Optional parts of the bundled toolchain. A lean install (see
+// scripts/split-toolchain.js) keeps only the compiler core in `c c++/` and
+// moves everything else into `c c++/components/<name>.pack`; a component is
+// extracted in place the first time a feature needs it (into the local copy
+// of the toolchain in a shared install, see lib/install.js). In a full
+// install there are no packs and ensure() does nothing.
+//
+// Pack format: "LGPACK1\n" followed by a brotli stream of records
+//   u32 name length | u32 size | u32 mode | name (utf-8, "/"-separated) | data
+const fs = require("fs");
+const path = require("path");
+const zlib = require("zlib");
+const { once } = require("events");
+const install = require("./install");
+
+const TOOLCHAIN = path.join(__dirname, "..", "c c++");
+const PACK_DIR = path.join(TOOLCHAIN, "components");
+const MAGIC = Buffer.from("LGPACK1\n");
+const HEADER = 12;
+const GCC_LIB = "x86_64-w64-mingw32/lib/gcc/x86_64-w64-mingw32";
+
+// The toolchain's GCC version as its directories are named (what
+// gcc -dumpfullversion prints): the version directory under GCC_LIB. Read
+// from disk so splitting works without running the Windows compiler.
+function gccVersion(root = TOOLCHAIN) {
+  try {
+    return fs.readdirSync(path.join(root, GCC_LIB)).find(d => /^\d+(\.\d+)*$/.test(d)) || null;
+  } catch (_) {
+    return null;
+  }
+}
+
+// `#include <x>` / `#include "x"` targets of a source file
+const includesOf = code => [...String(code).matchAll(/^\s*#\s*include\s*[<"]([^>"]+)[>"]/gm)].map(m => m[1]);
+
+// Paths are relative to the toolchain root; a directory covers everything
+// below it, and {gcc} stands for gccVersion(). `when(code, command)` marks a
+// component a build needs.
+const COMPONENTS = {
+  gdb: {
+    title: "gdb and its data files",
+    paths: ["bin/gdbserver.exe", "bin/gdb-add-index", "bin/gcore", "bin/gstack", "include/gdb",
+      "share/gdb", "share/gcc-{gcc}", "share/source-highlight", "share/tabset", "share/terminfo"]
+  },
+  tools: {
+    title: "profiling and binary tools",
+    paths: ["bin/addr2line.exe", "bin/c++filt.exe", "bin/dllwrap.exe", "bin/elfedit.exe", "bin/gcov.exe", "bin/gcov-dump.exe",
+      "bin/gcov-tool.exe", "bin/gendef.exe", "bin/genidl.exe", "bin/genpeimg.exe", "bin/gprof.exe", "bin/objdump.exe",
+      "bin/readelf.exe", "bin/size.exe", "bin/strings.exe", "bin/widl.exe", "bin/windmc.exe", "bin/windres.exe"]
+  },
+  sdk: {
+    title: "DDK, OpenCL and GDI+ headers and libraries",
+    paths: ["include/ddk", "include/CL", "include/KHR", "include/gdiplus", "include/gdiplus.h", "include/wrl", "include/wrl.h",
+      "x86_64-w64-mingw32/lib/libgdiplus.a", "x86_64-w64-mingw32/lib/libopencl.a"],
+    when: (code, command) => includesOf(code).some(f => /^(ddk|CL|KHR|gdiplus|wrl)([/.]|$)/i.test(f)) ||
+      /\s-l(gdiplus|opencl)\b/i.test(command)
+  },
+  m32: {
+    title: "32-bit (-m32) headers and libraries",
+    paths: ["i686-w64-mingw32", GCC_LIB + "/{gcc}/32"],
+    when: (_, command) => /\s-m32\b/.test(command)
+  },
+  smartcard: {
+    title: "OpenSC, OpenSSL and osslsigncode",
+    paths: ["bin/libopensc-12-x64.dll", "bin/libssl-3-x64.dll", "bin/opensc-minidriver.dll", "bin/opensc-tool.exe",
+      "bin/openssl.exe", "bin/osslsigncode.exe", "bin/pkcs11-tool.exe", "bin/pkcs15-crypt.exe", "bin/pkcs15-init.exe",
+      "bin/pkcs15-tool.exe", "bin/sc-hsm-tool.exe", "share/opensc", "share/ssl"]
+  },
+  docs: {
+    title: "info, man and html documentation",
+    paths: ["share/doc", "share/info", "share/man"]
+  }
+};
+
+const packFile = (root, name) => path.join(root, "components", name + ".pack");
+const marker = (root, name) => path.join(root, "components", name + ".extracted");
+
+// files (relative, "/"-separated) of a component present under `root`
+function filesOf(name, root = TOOLCHAIN) {
+  const out = [];
+  const walk = rel => {
+    const abs = path.join(root, rel);
+    let st;
+    try { st = fs.statSync(abs); } catch (_) { return; }
+    if (!st.isDirectory()) return out.push(rel);
+    for (const ent of fs.readdirSync(abs)) walk(rel + "/" + ent);
+  };
+  const version = gccVersion(root);
+  COMPONENTS[name].paths.filter(p => version || !p.includes("{gcc}")).forEach(p => walk(p.replace("{gcc}", version)));
+  return out;
+}
+
+// -> { files, bytes, packed }
+async function pack(file, root, files) {
+  const tmp = file + ".tmp";
+  const out = fs.createWriteStream(tmp);
+  out.write(MAGIC);
+  const br = zlib.createBrotliCompress({
+    params: { [zlib.constants.BROTLI_PARAM_QUALITY]: 9, [zlib.constants.BROTLI_PARAM_LGWIN]: 24 }
+  });
+  br.pipe(out);
+  let bytes = 0;
+  for (const rel of files) {
+    const abs = path.join(root, rel);
+    const data = fs.readFileSync(abs);
+    const name = Buffer.from(rel, "utf8");
+    const head = Buffer.alloc(HEADER);
+    head.writeUInt32LE(name.length, 0);
+    head.writeUInt32LE(data.length, 4);
+    head.writeUInt32LE(fs.statSync(abs).mode & 0o777, 8);
+    bytes += data.length;
+    for (const buf of [head, name, data]) if (!br.write(buf)) await once(br, "drain");
+  }
+  br.end();
+  await once(out, "close");
+  fs.renameSync(tmp, file);
+  return { files: files.length, bytes, packed: fs.statSync(file).size };
+}
+
+// Streams a pack into `root`. Each file is written as <file>.part and renamed
+// when complete, so an interrupted extraction never leaves a truncated exe.
+function extract(file, root) {
+  const fd = fs.openSync(file, "r");
+  const magic = Buffer.alloc(MAGIC.length);
+  fs.readSync(fd, magic, 0, magic.length, 0);
+  fs.closeSync(fd);
+  if (!magic.equals(MAGIC)) return Promise.reject(new Error(path.basename(file) + " is not a component pack"));
+
+  return new Promise((resolve, reject) => {
+    const input = fs.createReadStream(file, { start: MAGIC.length });
+    const br = zlib.createBrotliDecompress();
+    let buf = Buffer.alloc(0);
+    let cur = null;
+    let count = 0;
+    const fail = err => {
+      input.destroy();
+      br.destroy();
+      if (cur) fs.closeSync(cur.fd);
+      cur = null;
+      reject(err);
+    };
+
+    br.on("data", chunk => {
+      try {
+        buf = buf.length ? Buffer.concat([buf, chunk]) : chunk;
+        for (;;) {
+          if (!cur) {
+            if (buf.length < HEADER) break;
+            const nameLen = buf.readUInt32LE(0);
+            if (buf.length < HEADER + nameLen) break;
+            const rel = buf.toString("utf8", HEADER, HEADER + nameLen);
+            if (path.isAbsolute(rel) || rel.split("/").includes("..")) throw new Error("bad path in pack: " + rel);
+            const dest = path.join(root, rel);
+            fs.mkdirSync(path.dirname(dest), { recursive: true });
+            cur = { dest, fd: fs.openSync(dest + ".part", "w", buf.readUInt32LE(8) || 0o644), left: buf.readUInt32LE(4) };
+            buf = buf.subarray(HEADER + nameLen);
+          }
+          const n = Math.min(cur.left, buf.length);
+          if (n) fs.writeSync(cur.fd, buf, 0, n);
+          buf = buf.subarray(n);
+          cur.left -= n;
+          if (cur.left) break;
+          fs.closeSync(cur.fd);
+          fs.renameSync(cur.dest + ".part", cur.dest);
+          cur = null;
+          count++;
+        }
+      } catch (err) {
+        fail(err);
+      }
+    });
+    br.on("end", () => (cur || buf.length ? fail(new Error(path.basename(file) + " is truncated")) : resolve(count)));
+    br.on("error", fail);
+    input.on("error", fail);
+    input.pipe(br);
+  });
+}
+
+function installed(name, root = TOOLCHAIN) {
+  return !fs.existsSync(packFile(root, name)) || fs.existsSync(marker(root, name));
+}
+
+const pending = new Map();
+
+// Extract `name` if this is a lean install and it is not there yet. Resolves
+// true when something was extracted; concurrent callers share one extraction.
+function ensure(name) {
+  if (!COMPONENTS[name]) return Promise.reject(new Error("unknown toolchain component " + name));
+  if (installed(name)) return Promise.resolve(false);
+  if (!pending.has(name)) {
+    pending.set(name, install.warm("toolchain").then(async root => {
+      if (installed(name, root)) return false;
+      const count = await extract(packFile(root, name), root);
+      fs.writeFileSync(marker(root, name), JSON.stringify({ files: count, date: new Date().toISOString() }));
+      return true;
+    }).then(done => {
+      pending.delete(name);
+      return done;
+    }, err => {
+      pending.delete(name);
+      throw new Error(`extracting toolchain component "${name}" failed: ${err.message}`);
+    }));
+  }
+  return pending.get(name);
+}
+
+// components a build of `code` with `command` needs
+function needed(code, command) {
+  return Object.keys(COMPONENTS).filter(name => COMPONENTS[name].when && COMPONENTS[name].when(code, " " + command));
+}
+
+function ensureFor(code, command) {
+  return Promise.all(needed(code, command).map(ensure));
+}
+
+module.exports = { TOOLCHAIN, PACK_DIR, COMPONENTS, gccVersion, filesOf, pack, extract, installed, ensure, needed, ensureFor };
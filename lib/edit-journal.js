@@ -0,0 +1,310 @@
+// Crash-safe edit journal for the editor buffer (autosave).
+//
+// The renderer sends Monaco's content-change deltas in small batches; each
+// batch is appended to <dir>/session-<id>.journal as one JSON line and
+// fdatasync'ed, so a power cut loses at most the batch in flight. The text is
+// kept here as well (deltas applied to 64 KB chunks), and every `compactMs` of
+// editing, or once the journal reaches `compactBytes`, it is compacted: the
+// text is written to the real file (for an untitled buffer, to
+// session-<id>.base) through a temp file and rename, and the journal starts
+// over. Saving never sends the whole buffer across IPC.
+//
+// <id> is random per session (pids repeat after a reboot). A running session
+// keeps session-<id>.lock ({ pid }) fresh; a journal whose lock is missing,
+// stale or names a dead process belongs to a session that is gone.
+//
+// Journal lines:
+//   { "v": 1, "file": path | null, "lang", "base": sha256, "seq", "created" }  header
+//   { "s": seq, "c": [[offset, length, text], ...] }                           edit batch
+//   { "compact": sha256, "seq" }                                               about to write the base
+// Recovery replays the batches on top of the base when its hash is the
+// header's; when a crash hit between writing the base and restarting the
+// journal, the base matches the last "compact" line and only the batches
+// after it are replayed. A base that matches neither was changed outside the
+// app, which wins.
+const crypto = require("crypto");
+const fs = require("fs");
+const path = require("path");
+
+const sha256 = text => crypto.createHash("sha256").update(text, "utf8").digest("hex");
+
+// the text as Monaco holds it: no BOM, one kind of line break (the majority,
+// LF when there are none), so delta offsets line up
+function normalize(text) {
+  if (text.charCodeAt(0) === 0xfeff) text = text.slice(1);
+  // already consistent: all LF, or all CRLF
+  if (!text.includes("\r") || !/\r(?!\n)|(^|[^\r])\n/.test(text)) return text;
+  const crlf = (text.match(/\r\n/g) || []).length;
+  const breaks = (text.match(/\r\n|\r|\n/g) || []).length;
+  return text.replace(/\r\n|\r|\n/g, crlf > breaks / 2 ? "\r\n" : "\n");
+}
+
+// The buffer as chunks of about CHUNK characters, so applying a delta to a
+// large file touches one chunk instead of copying the whole text.
+const CHUNK = 64 * 1024;
+
+class Text {
+  constructor(text) {
+    this.parts = [];
+    for (let i = 0; i < text.length; i += CHUNK) this.parts.push(text.slice(i, i + CHUNK));
+    if (!this.parts.length) this.parts.push("");
+  }
+
+  // Monaco's changes of one event, applied in order
+  apply(changes) {
+    for (const [offset, length, insert] of changes) this.splice(offset, length, insert);
+    return this;
+  }
+
+  splice(offset, length, insert) {
+    let i = 0;
+    let start = 0;
+    while (i < this.parts.length - 1 && start + this.parts[i].length < offset) start += this.parts[i++].length;
+    let k = i;
+    let end = start + this.parts[i].length;
+    while (k < this.parts.length - 1 && end < offset + length) end += this.parts[++k].length;
+    const joined = this.parts.slice(i, k + 1).join("");
+    const s = joined.slice(0, offset - start) + insert + joined.slice(offset - start + length);
+    const pieces = [];
+    for (let p = 0; p < s.length; p += CHUNK) pieces.push(s.slice(p, p + CHUNK));
+    this.parts.splice(i, k - i + 1, ...(pieces.length ? pieces : [""]));
+  }
+
+  toString() {
+    return this.parts.join("");
+  }
+}
+
+const HEARTBEAT_MS = 10_000;
+const STALE_MS = 3 * HEARTBEAT_MS;
+
+function alive(pid) {
+  try {
+    process.kill(pid, 0);
+    return true;
+  } catch (err) {
+    return err.code === "EPERM";
+  }
+}
+
+// a session's lock: kept fresh by a live process
+async function running(lockFile) {
+  try {
+    const st = await fs.promises.stat(lockFile);
+    const { pid } = JSON.parse(await fs.promises.readFile(lockFile, "utf8"));
+    return Date.now() - st.mtimeMs < STALE_MS && alive(pid);
+  } catch (_) {
+    return false;
+  }
+}
+
+async function writeAtomic(file, text) {
+  const tmp = `${file}.${process.pid}.tmp`;
+  const fh = await fs.promises.open(tmp, "w");
+  try {
+    await fh.writeFile(text, "utf8");
+    await fh.sync();
+  } finally {
+    await fh.close();
+  }
+  await fs.promises.rename(tmp, file);
+}
+
+class EditJournal {
+  constructor(dir, opts = {}) {
+    this.dir = dir;
+    this.compactBytes = opts.compactBytes || 256 * 1024;
+    this.compactMs = opts.compactMs || 30_000;
+    this.id = crypto.randomBytes(8).toString("hex");
+    this.file = path.join(dir, `session-${this.id}.journal`);
+    this.baseFile = path.join(dir, `session-${this.id}.base`);
+    this.lockFile = path.join(dir, `session-${this.id}.lock`);
+    this.heartbeat = null;
+    this.doc = null; // { file, lang }
+    this.text = new Text("");
+    this.seq = 0;
+    this.bytes = 0;
+    this.fh = null;
+    this.dirtySince = 0;
+    this.compactTimer = null;
+    this.io = Promise.resolve(); // every write, in order
+  }
+
+  // Start journaling a document: `file` (its content on disk is the base) or
+  // null for an untitled buffer whose base is `content`. The previous
+  // document is compacted first. For a file, resolves false when the editor's
+  // text (`length`) is not what is on disk; the caller then begins again with
+  // `content`, which is written to the file.
+  begin({ file = null, lang = "", length = -1, content = null }) {
+    if (this.dirtySince) this.compact();
+    return this.queue(async () => {
+      let text = content;
+      if (text === null) {
+        if (!file) return false;
+        text = normalize(await fs.promises.readFile(file, "utf8"));
+        if (text.length !== length) return false;
+      }
+      await fs.promises.mkdir(this.dir, { recursive: true });
+      await this.lock();
+      if (content !== null) await writeAtomic(file || this.baseFile, text);
+      this.doc = { file, lang };
+      this.text = new Text(text);
+      this.seq = 0;
+      await this.restart(sha256(text), 0);
+      return true;
+    });
+  }
+
+  // seq: the renderer's batch counter, checked so a lost batch stops the
+  // journal instead of replaying shifted offsets
+  append(seq, changes) {
+    if (!this.doc || !changes.length) return;
+    if (seq !== this.seq) {
+      console.error(`edit journal: batch ${seq} after ${this.seq - 1}; stopped until the next begin`);
+      this.doc = null;
+      return;
+    }
+    this.seq++;
+    this.text.apply(changes);
+    const line = JSON.stringify({ s: seq, c: changes }) + "\n";
+    this.bytes += Buffer.byteLength(line);
+    this.queue(async () => {
+      await this.fh.write(line);
+      await this.fh.datasync();
+    });
+    if (!this.dirtySince) {
+      this.dirtySince = Date.now();
+      this.compactTimer = setTimeout(() => this.compact(), this.compactMs);
+    }
+    if (this.bytes >= this.compactBytes) this.compact();
+  }
+
+  // Write the text to the real file (or the untitled base); resolves with its
+  // path. The text is taken now: batches appended while the write is queued
+  // go to the new journal.
+  compact() {
+    clearTimeout(this.compactTimer);
+    this.dirtySince = 0;
+    if (!this.doc) return Promise.resolve(null);
+    const { doc, seq } = this;
+    const text = this.text.toString();
+    const hash = sha256(text);
+    this.bytes = 0;
+    return this.queue(async () => {
+      await this.fh.write(JSON.stringify({ compact: hash, seq }) + "\n");
+      await this.fh.datasync();
+      await writeAtomic(doc.file || this.baseFile, text);
+      await this.restart(hash, seq, doc);
+      return doc.file || this.baseFile;
+    });
+  }
+
+  // new journal starting at `seq` on a base with `hash`, replacing the old one atomically
+  async restart(hash, seq, doc = this.doc) {
+    const header = JSON.stringify({ v: 1, file: doc.file, lang: doc.lang, base: hash, seq, created: Date.now() }) + "\n";
+    if (this.fh) await this.fh.close();
+    this.fh = null;
+    await writeAtomic(this.file, header);
+    this.fh = await fs.promises.open(this.file, "a");
+  }
+
+  // mark the session as running before its first journal is written
+  async lock() {
+    if (this.heartbeat) return;
+    await fs.promises.writeFile(this.lockFile, JSON.stringify({ pid: process.pid }));
+    this.heartbeat = setInterval(() => {
+      const now = new Date();
+      fs.promises.utimes(this.lockFile, now, now).catch(() => {});
+    }, HEARTBEAT_MS);
+    this.heartbeat.unref();
+  }
+
+  // Clean exit: compact, and drop the journal of a file (the file has
+  // everything). An untitled buffer's journal stays and is recovered on the
+  // next start.
+  async close() {
+    if (this.dirtySince) this.compact();
+    await this.queue(async () => {
+      if (this.fh) await this.fh.close();
+      this.fh = null;
+      if (this.doc && this.doc.file) await fs.promises.rm(this.file, { force: true });
+      clearInterval(this.heartbeat);
+      this.heartbeat = null;
+      await fs.promises.rm(this.lockFile, { force: true });
+    });
+  }
+
+  queue(fn) {
+    const run = this.io.then(fn);
+    this.io = run.catch(err => console.error("edit journal:", err.message));
+    return run;
+  }
+
+  // Newest journal left by a session that is no longer running, replayed
+  // and adopted as this session's: -> { file, lang, content, edits } or null.
+  // A recovered file is written back right away.
+  async recover() {
+    let names = [];
+    try { names = await fs.promises.readdir(this.dir); } catch (_) { return null; }
+    const found = [];
+    for (const n of names) {
+      // the lock of a session that ended before writing a journal
+      const l = /^session-([0-9a-f]+)\.lock$/.exec(n);
+      if (l && l[1] !== this.id && !names.includes(`session-${l[1]}.journal`) && !await running(path.join(this.dir, n))) {
+        await fs.promises.rm(path.join(this.dir, n), { force: true });
+      }
+      const m = /^session-([0-9a-f]+)\.journal$/.exec(n);
+      if (!m || m[1] === this.id || await running(path.join(this.dir, `session-${m[1]}.lock`))) continue;
+      found.push({ id: m[1], mtime: (await fs.promises.stat(path.join(this.dir, n))).mtimeMs });
+    }
+    for (const { id } of found.sort((a, b) => b.mtime - a.mtime)) {
+      const [journal, base, lock] = ["journal", "base", "lock"].map(ext => path.join(this.dir, `session-${id}.${ext}`));
+      const doc = await replay(journal, base).catch(err => {
+        console.error(`edit journal: session-${id}: ${err.message}`);
+        return null;
+      });
+      if (doc && (!doc.file || doc.edits)) await this.begin({ file: doc.file, lang: doc.lang, content: doc.content });
+      for (const f of [journal, base, lock]) await fs.promises.rm(f, { force: true });
+      if (doc && (!doc.file || doc.edits)) return doc;
+    }
+    return null;
+  }
+}
+
+// -> { file, lang, content, edits } (edits: batches replayed); rejects when
+// the journal is unreadable or its base changed outside the app
+async function replay(journal, baseFile) {
+  const lines = (await fs.promises.readFile(journal, "utf8")).split("\n");
+  const header = JSON.parse(lines[0]);
+  const base = normalize(await fs.promises.readFile(header.file || baseFile, "utf8"));
+  const have = sha256(base);
+  const text = new Text(base);
+  const records = [];
+  for (const line of lines.slice(1)) {
+    try {
+      records.push(JSON.parse(line));
+    } catch (_) {
+      break; // torn last write
+    }
+  }
+  let start = have === header.base ? 0 : -1;
+  let seq = header.seq;
+  records.forEach((r, i) => {
+    if (r.compact === have) {
+      start = i + 1;
+      seq = r.seq;
+    }
+  });
+  if (start < 0) throw new Error(`${header.file || "untitled buffer"} changed outside the editor; journal discarded`);
+  let edits = 0;
+  for (const r of records.slice(start)) {
+    if (!r.c) continue;
+    if (r.s !== seq) break; // a gap: stop at the last consistent state
+    text.apply(r.c);
+    seq++;
+    edits++;
+  }
+  return { file: header.file, lang: header.lang, content: text.toString(), edits };
+}
+
+module.exports = { EditJournal, normalize };
@@ -0,0 +1,98 @@
+// gcov support for the "Coverage" action: build with --coverage, and read the
+// per-line execution counts back from gcov's JSON intermediate format.
+//
+// Counts accumulate in the .gcda file across runs of the same build, so the
+// coverage build is reused while the source is unchanged and each result
+// carries both the running totals and what the last run added.
+const { execFile } = require("child_process");
+const crypto = require("crypto");
+const fs = require("fs");
+const path = require("path");
+const install = require("./install");
+
+const gcov = () => path.join(install.dir("toolchain"), "bin", "gcov.exe");
+
+// -O0 after the default -O2 so counts map 1:1 onto source lines
+const COVERAGE_FLAGS = ["--coverage", "-O0", "-g"];
+const EXE_NAME = "main-cov.exe";
+
+function run(exe, args, cwd) {
+  return new Promise((resolve, reject) => {
+    execFile(exe, args, { cwd, maxBuffer: 64 * 1024 * 1024, timeout: 30_000, windowsHide: true }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve(out);
+    });
+  });
+}
+
+// gcc names the notes/data files after the output: main-cov-main.gcno/.gcda
+function dataFiles(dir, ext) {
+  const stem = path.basename(EXE_NAME, ".exe");
+  return fs.readdirSync(dir).filter(f => f.startsWith(stem) && f.endsWith(ext)).map(f => path.join(dir, f));
+}
+
+class Coverage {
+  constructor(dir) {
+    this.dir = dir;
+    this.exe = path.join(dir, EXE_NAME);
+    this.hash = null;     // source the current build was made from
+    this.previous = null; // line -> count after the previous run
+    this.runs = 0;
+  }
+
+  // true when `code` needs a new build; also drops the stale counters
+  prepare(code) {
+    const hash = crypto.createHash("sha1").update(code).digest("hex");
+    if (hash === this.hash && fs.existsSync(this.exe)) return false;
+    this.reset();
+    this.hash = hash;
+    return true;
+  }
+
+  // forget accumulated counts (next run starts from zero)
+  reset() {
+    for (const f of dataFiles(this.dir, ".gcda")) fs.rmSync(f, { force: true });
+    this.previous = null;
+    this.runs = 0;
+  }
+
+  // Read counts for `source` after a run:
+  // { runs, lines: [{ line, count, delta, fn }], functions, summary }
+  async collect(source) {
+    const gcda = dataFiles(this.dir, ".gcda");
+    if (!gcda.length) throw new Error("no coverage data written (the program must return from main or call exit)");
+    const json = JSON.parse(await run(gcov(), ["--json-format", "--stdout", ...gcda], this.dir));
+    const base = path.basename(source).toLowerCase();
+    const file = (json.files || []).find(f => path.basename(f.file).toLowerCase() === base);
+    if (!file) throw new Error("gcov produced no data for " + path.basename(source));
+
+    this.runs++;
+    const counts = new Map();
+    for (const l of file.lines) counts.set(l.line_number, (counts.get(l.line_number) || 0) + l.count);
+    const fnAt = new Map(file.lines.map(l => [l.line_number, l.function_name]));
+    const lines = [...counts].sort((a, b) => a[0] - b[0]).map(([line, count]) => ({
+      line,
+      count,
+      delta: this.previous ? count - (this.previous.get(line) || 0) : count,
+      fn: fnAt.get(line) || null
+    }));
+    this.previous = counts;
+
+    const functions = (file.functions || []).map(f => ({
+      name: f.demangled_name || f.name,
+      line: f.start_line,
+      calls: f.execution_count,
+      blocks: f.blocks,
+      blocksExecuted: f.blocks_executed
+    }));
+    const executed = lines.filter(l => l.count > 0).length;
+    return {
+      runs: this.runs,
+      lines,
+      functions,
+      summary: { lines: lines.length, executed, percent: lines.length ? +(100 * executed / lines.length).toFixed(1) : 0 }
+    };
+  }
+}
+
+module.exports = { COVERAGE_FLAGS, Coverage };
@@ -0,0 +1,194 @@
+// Minimal gdb/MI driver for the debugger panel.
+//
+// Start-up is kept short: gdb runs with -nx (no system-gdbinit, so nothing is
+// imported from share/gdb/python up front), auto-loading of the libstdc++
+// printer script is off and DLL symbols are not read. The libstdc++ pretty
+// printers are registered the first time a std:: value is expanded, and the
+// symbol index of the program is kept in gdb's index cache between sessions.
+const { spawn } = require("child_process");
+const EventEmitter = require("events");
+const fs = require("fs");
+const path = require("path");
+const install = require("./install");
+const { gccVersion } = require("./components");
+
+// flags added to the normal compile line for a debug build (last -O wins)
+const DEBUG_FLAGS = ["-g", "-O0"];
+
+function gdbPath() {
+  const bundled = path.join(install.dir("toolchain"), "bin", "gdb.exe");
+  return fs.existsSync(bundled) ? bundled : "gdb";
+}
+
+// ---- MI output syntax ----
+// value: const | tuple | list ; const is a C string
+function parseValue(s, i) {
+  if (s[i] === '"') {
+    let out = "";
+    for (i++; i < s.length && s[i] !== '"'; i++) {
+      if (s[i] !== "\\") { out += s[i]; continue; }
+      const c = s[++i];
+      if (c === "n") out += "\n";
+      else if (c === "t") out += "\t";
+      else if (c === "r") out += "\r";
+      else if (/[0-7]/.test(c)) { out += String.fromCharCode(parseInt(s.substr(i, 3), 8)); i += 2; }
+      else out += c;
+    }
+    return [out, i + 1];
+  }
+  if (s[i] === "{") return parseResults(s, i + 1, "}");
+  if (s[i] === "[") {
+    // a list holds either values or name=value results
+    const list = [];
+    i++;
+    while (i < s.length && s[i] !== "]") {
+      const eq = /^[\w-]+=/.exec(s.slice(i, i + 64));
+      if (eq) i += eq[0].length;
+      let v;
+      [v, i] = parseValue(s, i);
+      list.push(v);
+      if (s[i] === ",") i++;
+    }
+    return [list, i + 1];
+  }
+  return [null, i];
+}
+
+function parseResults(s, i, end) {
+  const obj = {};
+  while (i < s.length && s[i] !== end) {
+    const eq = s.indexOf("=", i);
+    const key = s.slice(i, eq);
+    let v;
+    [v, i] = parseValue(s, eq + 1);
+    obj[key] = v;
+    if (s[i] === ",") i++;
+  }
+  return [obj, i + 1];
+}
+
+// one MI output line -> { type, token, cls, data } or null (not MI: program output)
+function parseLine(line) {
+  const m = /^(\d*)([\^*=+~@&])(.*)$/.exec(line);
+  if (!m) return null;
+  const [, token, sigil, rest] = m;
+  if ("~@&".includes(sigil)) {
+    if (rest[0] !== '"') return null;
+    return { type: sigil === "~" ? "console" : sigil === "@" ? "target" : "log", data: parseValue(rest, 0)[0] };
+  }
+  const comma = rest.indexOf(",");
+  const cls = comma < 0 ? rest : rest.slice(0, comma);
+  if (!/^[\w-]+$/.test(cls)) return null;
+  const data = comma < 0 ? {} : parseResults(rest, comma + 1, undefined)[0];
+  const type = { "^": "result", "*": "exec", "=": "notify", "+": "status" }[sigil];
+  return { type, token: token ? +token : null, cls, data };
+}
+
+// ---- session ----
+// events: "stopped" (MI *stopped data), "running", "output" (text for the
+// terminal), "exit" (gdb's exit code)
+class GdbSession extends EventEmitter {
+  constructor({ cwd, indexCache }) {
+    super();
+    this.cwd = cwd;
+    this.indexCache = indexCache;
+    this.token = 1;
+    this.pending = new Map();
+    this.printersLoaded = false;
+    this.proc = null;
+  }
+
+  async start(exe) {
+    const args = [
+      "--interpreter=mi2", "-q", "-nx",
+      "-iex", "set auto-load python-scripts off",
+      "-iex", "set auto-solib-add off",
+      "-iex", `set index-cache directory ${this.indexCache.replace(/\\/g, "/")}`,
+      "-iex", "set index-cache enabled on",
+      exe
+    ];
+    this.proc = spawn(gdbPath(), args, { cwd: this.cwd, windowsHide: true });
+    let buf = "";
+    this.proc.stdout.on("data", d => {
+      buf += d.toString();
+      let nl;
+      while ((nl = buf.indexOf("\n")) >= 0) {
+        this.onLine(buf.slice(0, nl).replace(/\r$/, ""));
+        buf = buf.slice(nl + 1);
+      }
+    });
+    this.proc.stderr.on("data", d => this.emit("output", d.toString()));
+    this.proc.on("error", err => this.emit("output", `\n${err.message}\n`));
+    this.proc.on("close", code => {
+      for (const { reject } of this.pending.values()) reject(new Error("gdb exited"));
+      this.pending.clear();
+      this.proc = null;
+      this.emit("exit", code);
+    });
+    await new Promise((resolve, reject) => {
+      this.proc.once("spawn", resolve);
+      this.proc.once("error", reject);
+    });
+    // program output in its own console on Windows: gdb's stdin carries MI commands
+    if (process.platform === "win32") await this.command("-gdb-set new-console on");
+  }
+
+  onLine(line) {
+    if (line === "(gdb) " || line === "(gdb)") return;
+    const rec = parseLine(line);
+    if (!rec) return this.emit("output", line + "\n");
+    if (rec.type === "result") {
+      const p = this.pending.get(rec.token);
+      if (!p) return;
+      this.pending.delete(rec.token);
+      if (rec.cls === "error") p.reject(new Error(rec.data.msg || "gdb error"));
+      else p.resolve(rec.data);
+    } else if (rec.type === "exec") {
+      this.emit(rec.cls, rec.data);
+    } else if (rec.type === "console" || rec.type === "target") {
+      this.emit("output", rec.data);
+    }
+  }
+
+  command(cmd) {
+    if (!this.proc) return Promise.reject(new Error("debugger is not running"));
+    const token = this.token++;
+    return new Promise((resolve, reject) => {
+      this.pending.set(token, { resolve, reject });
+      this.proc.stdin.write(`${token}${cmd}\n`);
+    });
+  }
+
+  // register the libstdc++ printers on first use; varobjs created later use them
+  async ensurePrinters() {
+    if (this.printersLoaded) return;
+    this.printersLoaded = true;
+    const toolchain = install.dir("toolchain");
+    const dir = path.join(toolchain, "share", `gcc-${gccVersion(toolchain)}`, "python").replace(/\\/g, "/");
+    const py = `python import sys; sys.path.insert(0, '${dir}'); from libstdcxx.v6 import register_libstdcxx_printers; register_libstdcxx_printers(None)`;
+    await this.command(`-interpreter-exec console ${JSON.stringify(py)}`).catch(() => {});
+    await this.command("-enable-pretty-printing").catch(() => {});
+  }
+
+  // resolves once gdb (and with it the program) is gone, so the exe can be
+  // rebuilt; killed when -gdb-exit has not ended it within a second
+  stop() {
+    if (!this.proc) return Promise.resolve();
+    const proc = this.proc;
+    return new Promise(resolve => {
+      const kill = setTimeout(() => { try { proc.kill(); } catch (_) {} }, 1000);
+      const giveUp = setTimeout(resolve, 5000);
+      proc.once("close", () => {
+        clearTimeout(kill);
+        clearTimeout(giveUp);
+        resolve();
+      });
+      this.command("-gdb-exit").catch(() => {});
+    });
+  }
+}
+
+// a C/C++ value whose display benefits from the libstdc++ printers
+const needsPrinters = type => /\bstd::|__gnu_cxx::/.test(type || "");
+
+module.exports = { DEBUG_FLAGS, GdbSession, parseLine, needsPrinters };
@@ -0,0 +1,123 @@
+// gprof support for the "Profile" action: run gprof on gmon.out and turn its
+// flat profile and call graph into plain objects, with each function mapped to
+// its source line via `nm -l` (the profile build adds -g for that).
+const { execFile } = require("child_process");
+const path = require("path");
+const install = require("./install");
+
+const tool = name => path.join(install.dir("toolchain"), "bin", name + ".exe");
+
+// flags added to the normal compile line for a profiling build
+const PROFILE_FLAGS = ["-pg", "-g", "-fno-omit-frame-pointer", "-fno-inline-functions-called-once"];
+
+function run(exe, args, cwd) {
+  return new Promise((resolve, reject) => {
+    execFile(exe, args, { cwd, maxBuffer: 32 * 1024 * 1024, timeout: 30_000, windowsHide: true }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve(out);
+    });
+  });
+}
+
+const num = s => (s === undefined || s === "" ? null : Number(s));
+
+//  %   cumulative   self              self     total
+// time   seconds   seconds    calls  ms/call  ms/call  name
+// 60.00      0.06     0.06        1    60.00   100.00  fib(int)
+function parseFlat(text) {
+  const start = text.indexOf("Flat profile:");
+  if (start < 0) return [];
+  const end = text.indexOf("Call graph", start);
+  const rows = [];
+  const re = /^\s*([\d.]+)\s+([\d.]+)\s+([\d.]+)(?:\s+(\d+)\s+([\d.]+)\s+([\d.]+))?\s+(\S.*)$/;
+  for (const line of text.slice(start, end < 0 ? undefined : end).split(/\r?\n/)) {
+    const m = re.exec(line);
+    if (!m) continue;
+    rows.push({
+      name: m[7].trim(),
+      percent: num(m[1]),
+      cumulative: num(m[2]),
+      self: num(m[3]),
+      calls: num(m[4]),
+      selfMsPerCall: num(m[5]),
+      totalMsPerCall: num(m[6])
+    });
+  }
+  return rows;
+}
+
+// Split "<numbers...> name [N]" into its numeric columns and the name.
+// The "called" column is the one with '/' or '+', or the only one on recursive edges.
+function splitRow(line) {
+  const m = /^(.*?)\s+\[(\d+)\]\s*$/.exec(line);
+  if (!m) return null;
+  const tokens = m[1].trim().split(/\s+/);
+  const nums = [];
+  while (tokens.length > 1 && /^[\d.]+(?:[+/]\d+)?$/.test(tokens[0])) nums.push(tokens.shift());
+  return { nums, name: tokens.join(" "), index: +m[2] };
+}
+
+// One entry per "[N]" block: callers above the primary line, callees below.
+function parseCallGraph(text) {
+  const start = text.indexOf("index % time");
+  if (start < 0) return [];
+  const end = text.indexOf("Index by function name", start);
+  const nodes = [];
+  for (const block of text.slice(start, end < 0 ? undefined : end).split(/^-{10,}\s*$/m)) {
+    let node = null;
+    const callers = [];
+    const callees = [];
+    for (const line of block.split(/\r?\n/)) {
+      const p = /^\[(\d+)\]\s+(.*)$/.exec(line);
+      if (p) {
+        const row = splitRow(p[2]);
+        if (!row || row.nums.length < 3) continue;
+        const [percent, self, children, called = ""] = row.nums;
+        node = { index: +p[1], percent: +percent, self: +self, children: +children, called, name: row.name };
+        continue;
+      }
+      if (/<spontaneous>/.test(line)) continue;
+      const row = splitRow(line);
+      if (!row || !row.nums.length) continue;
+      const called = row.nums.find(n => /[+/]/.test(n)) || (row.nums.length === 1 ? row.nums[0] : "");
+      const times = row.nums.filter(n => n !== called);
+      (node ? callees : callers).push({ name: row.name, index: row.index, self: num(times[0]), children: num(times[1]), called });
+    }
+    if (node) nodes.push({ ...node, callers, callees });
+  }
+  return nodes;
+}
+
+// `nm -C -l --defined-only` -> { "fib(int)": { file, line } } (text symbols only)
+function parseNmLines(text) {
+  const map = {};
+  for (const line of text.split(/\r?\n/)) {
+    const m = /^[0-9a-fA-F]+\s+[tT]\s+(.+?)\t(.+):(\d+)\s*$/.exec(line);
+    if (!m) continue;
+    map[m[1]] = { file: m[2], line: +m[3] };
+    // gprof may print C++ names without the parameter list
+    const bare = m[1].replace(/\(.*$/, "");
+    if (!(bare in map)) map[bare] = map[m[1]];
+  }
+  return map;
+}
+
+// Analyse gmon.out (in `cwd`) for `exe`; source is the file that was built.
+async function analyze(exe, cwd, source) {
+  const [report, symbols] = await Promise.all([
+    run(tool("gprof"), ["-b", exe, path.join(cwd, "gmon.out")], cwd),
+    run(tool("nm"), ["-C", "-l", "--defined-only", exe], cwd).catch(() => "")
+  ]);
+  const lines = parseNmLines(symbols);
+  const sameFile = f => path.basename(f).toLowerCase() === path.basename(source).toLowerCase();
+  const locate = name => {
+    const loc = lines[name] || lines[name.replace(/\(.*$/, "")];
+    return loc && sameFile(loc.file) ? loc.line : null;
+  };
+  const flat = parseFlat(report).map(r => ({ ...r, line: locate(r.name) }));
+  const callGraph = parseCallGraph(report).map(n => ({ ...n, line: locate(n.name) }));
+  const sample = /Each sample counts as ([\d.]+) seconds/.exec(report);
+  return { flat, callGraph, sampleSeconds: sample ? +sample[1] : null, raw: report };
+}
+
+module.exports = { PROFILE_FLAGS, parseFlat, parseCallGraph, parseNmLines, analyze };
@@ -0,0 +1,164 @@
+// Bulk grading: every .c/.cpp/.py/.js file in a folder is one submission.
+// Identical files (same content hash) are built and run once. One worker per
+// core takes a submission, builds it in its own directory and runs all test
+// cases through lib/testrun.js; the results are written as CSV and HTML.
+// Compiles run under the same runner as the cases (lib/benchrun.c), with a
+// time and memory limit that ends the whole compiler (cc1plus, as, ...).
+const { spawn } = require("child_process");
+const crypto = require("crypto");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const languages = require("../languages");
+const components = require("./components");
+const testrun = require("./testrun");
+
+const BY_EXT = { ".c": "c", ".cpp": "cpp", ".cc": "cpp", ".cxx": "cpp", ".py": "python", ".js": "javascript" };
+const COMPILE_TIMEOUT_MS = 60_000;
+const COMPILE_MEM_MB = 2048;
+
+// a languages/*.js compile command as argv (paths are double-quoted, nothing else is special)
+const argvOf = cmd => (cmd.match(/"[^"]*"|\S+/g) || []).map(a => a.replace(/^"(.*)"$/, "$1"));
+
+// -> [{ hash, lang, files: [name], path }] one entry per distinct content
+function listSubmissions(dir) {
+  const byHash = new Map();
+  for (const name of fs.readdirSync(dir).sort()) {
+    const lang = BY_EXT[path.extname(name).toLowerCase()];
+    const file = path.join(dir, name);
+    if (!lang || !fs.statSync(file).isFile()) continue;
+    // line endings differ between editors; they do not make a submission different
+    const text = fs.readFileSync(file, "utf8").replace(/\r\n?/g, "\n");
+    const hash = crypto.createHash("sha1").update(lang + "\0" + text).digest("hex");
+    if (byHash.has(hash)) byHash.get(hash).files.push(name);
+    else byHash.set(hash, { hash, lang, files: [name], path: file, text });
+  }
+  return [...byHash.values()];
+}
+
+// build in workDir; resolves to argv, or throws with the compiler output
+async function build(sub, workDir, runner) {
+  const cfg = languages[sub.lang];
+  const file = path.join(workDir, cfg.filename);
+  fs.writeFileSync(file, sub.text);
+  if (!cfg.compile) return cfg.argv(file);
+  const exe = path.join(workDir, "main.exe");
+  const cmd = cfg.compile(file, { out: exe });
+  await components.ensureFor(sub.text, cmd);
+  const statsFile = path.join(workDir, "compile.stats");
+  return new Promise((resolve, reject) => {
+    const args = ["--run", statsFile, String(COMPILE_TIMEOUT_MS), String(COMPILE_MEM_MB), ...argvOf(cmd)];
+    const child = spawn(runner, args, { cwd: workDir, windowsHide: true, stdio: ["ignore", "pipe", "pipe"] });
+    let out = "";
+    const keep = d => { if (out.length < 64 * 1024) out += d; };
+    child.stdout.on("data", keep);
+    child.stderr.on("data", keep);
+    child.on("error", reject);
+    child.on("close", () => {
+      const st = testrun.parseStats(statsFile) || { exit: null, limit: "" };
+      fs.rmSync(statsFile, { force: true });
+      if (st.limit === "time") return reject(new Error(`compile timed out (${COMPILE_TIMEOUT_MS / 1000} s)`));
+      if (st.limit === "memory") return reject(new Error(`compile ran out of memory (${COMPILE_MEM_MB} MB)`));
+      if (st.exit !== 0) return reject(new Error(out.trim() || "compile failed"));
+      resolve([exe]);
+    });
+  });
+}
+
+async function gradeOne(sub, cases, runner, workRoot, limits) {
+  const workDir = path.join(workRoot, sub.hash.slice(0, 12));
+  fs.mkdirSync(workDir, { recursive: true });
+  const res = { ...sub, text: undefined, status: "ok", compileError: null, cases: [] };
+  try {
+    const argv = await build(sub, workDir, runner);
+    res.cases = await testrun.runAll(runner, argv, cases, { ...limits, cwd: workDir, jobs: 1 }, () => {});
+  } catch (err) {
+    res.status = "compile error";
+    res.compileError = err.message.slice(0, 4000);
+  }
+  const measured = res.cases.filter(c => c.wallMs != null);
+  res.passed = res.cases.filter(c => c.status === "pass").length;
+  res.total = cases.length;
+  res.maxMs = measured.length ? Math.max(...measured.map(c => c.wallMs)) : null;
+  res.totalMs = measured.reduce((a, c) => a + c.wallMs, 0);
+  res.peakKB = measured.length ? Math.max(...measured.map(c => c.rssKB || 0)) : null;
+  return res;
+}
+
+// Grade every submission in `dir` against the cases in `casesDir`.
+// onProgress({ done, total, files, status }) after each distinct submission.
+async function gradeFolder({ dir, casesDir, runner, workRoot, timeMs, memMB, jobs = os.cpus().length }, onProgress) {
+  const subs = listSubmissions(dir);
+  const cases = testrun.loadCases(casesDir);
+  if (!subs.length) throw new Error(`no .c/.cpp/.py/.js files in ${dir}`);
+  if (!cases.length) throw new Error(`no .in files in ${casesDir}`);
+  fs.rmSync(workRoot, { recursive: true, force: true });
+  const results = new Array(subs.length);
+  let next = 0, done = 0;
+  const worker = async () => {
+    while (next < subs.length) {
+      const i = next++;
+      results[i] = await gradeOne(subs[i], cases, runner, workRoot, { timeMs, memMB });
+      onProgress({ done: ++done, total: subs.length, files: subs[i].files, status: results[i].status, passed: results[i].passed, cases: cases.length });
+    }
+  };
+  await Promise.all(Array.from({ length: Math.max(1, Math.min(jobs, subs.length)) }, worker));
+  return { results, cases: cases.map(c => c.name) };
+}
+
+// ---- reports: one row per file (duplicates point at the first file) ----
+function rows(report) {
+  const out = [];
+  for (const r of report.results) {
+    r.files.forEach((name, k) => out.push({ name, dupOf: k ? r.files[0] : "", r }));
+  }
+  return out.sort((a, b) => a.name.localeCompare(b.name));
+}
+
+const csvCell = v => (/[",\n]/.test(String(v)) ? `"${String(v).replace(/"/g, '""')}"` : String(v));
+const fmt = (v, d = 1) => (v == null ? "" : v.toFixed(d));
+
+function toCSV(report) {
+  const head = ["file", "language", "duplicate_of", "status", "passed", "total", "score_pct", "max_ms", "total_ms", "peak_mb", ...report.cases];
+  const lines = [head.join(",")];
+  for (const { name, dupOf, r } of rows(report)) {
+    lines.push([name, r.lang, dupOf, r.status, r.passed, r.total, fmt(100 * r.passed / r.total), fmt(r.maxMs), fmt(r.totalMs), fmt(r.peakKB && r.peakKB / 1024),
+      ...report.cases.map((_, i) => (r.cases[i] ? r.cases[i].status : ""))].map(csvCell).join(","));
+  }
+  return lines.join("\n") + "\n";
+}
+
+const esc = s => String(s).replace(/[&<>"]/g, c => ({ "&": "&amp;", "<": "&lt;", ">": "&gt;", '"': "&quot;" })[c]);
+
+function toHTML(report, title) {
+  const body = rows(report).map(({ name, dupOf, r }) => {
+    const cells = report.cases.map((_, i) => {
+      const c = r.cases[i];
+      return c ? `<td class="${c.status}" title="${esc(c.status)}${c.wallMs != null ? `, ${fmt(c.wallMs, 0)} ms` : ""}">${c.status === "pass" ? "✔" : "✘"}</td>` : "<td></td>";
+    }).join("");
+    const err = r.compileError ? `<details><summary>compile error</summary><pre>${esc(r.compileError)}</pre></details>` : "";
+    return `<tr><td>${esc(name)}${dupOf ? ` <small>(= ${esc(dupOf)})</small>` : ""}${err}</td><td>${r.lang}</td>` +
+      `<td class="num">${r.passed}/${r.total}</td><td class="num">${fmt(100 * r.passed / r.total, 0)}%</td>` +
+      `<td class="num">${fmt(r.maxMs, 0)}</td><td class="num">${fmt(r.peakKB && r.peakKB / 1024)}</td>${cells}</tr>`;
+  }).join("\n");
+  return `<!doctype html><meta charset="utf-8"><title>${esc(title)}</title>
+<style>
+body { font: 13px system-ui, sans-serif; margin: 16px; }
+table { border-collapse: collapse; }
+td, th { border: 1px solid #ddd; padding: 3px 6px; vertical-align: top; }
+td.num { text-align: right; font-variant-numeric: tabular-nums; }
+td.pass { background: #e3f4e0; text-align: center; }
+td.fail, td.crash, td.output, td.error { background: #fbe3e0; text-align: center; }
+td.time, td.memory { background: #fcefd9; text-align: center; }
+pre { white-space: pre-wrap; max-width: 80ch; }
+</style>
+<h2>${esc(title)}</h2>
+<p>${report.results.length} distinct submissions, ${report.cases.length} test cases, generated ${new Date().toLocaleString()}</p>
+<table>
+<tr><th>file</th><th>lang</th><th>passed</th><th>score</th><th>max ms</th><th>peak MB</th>${report.cases.map(c => `<th>${esc(c)}</th>`).join("")}</tr>
+${body}
+</table>
+`;
+}
+
+module.exports = { listSubmissions, gradeFolder, toCSV, toHTML };
@@ -0,0 +1,56 @@
+// Header resolution map for the bundled gcc. The preprocessor looks up every
+// `#include <x>` by trying each directory of its search chain in turn (for
+// C++: libstdc++, its target and backward dirs, gcc's include and
+// include-fixed, then the mingw-w64 headers); every miss is a failed open,
+// and real-time antivirus makes those slow on Windows.
+//
+// scripts/build-header-map.js resolves all headers once at install time and
+// hard-links each winner into c c++/include-map/<c|c++>. Builds put that
+// directory in front of the chain with -isystem, so almost every header is
+// found by the first probe. Headers whose meaning depends on where they were
+// found (#include_next, quoted includes of siblings that resolve differently)
+// are left out and still go through the normal chain.
+const { execFile } = require("child_process");
+const fs = require("fs");
+const path = require("path");
+const { toolchainId } = require("./hostcpu");
+const install = require("./install");
+
+const mapDir = () => path.join(install.dir("toolchain"), "include-map");
+const NULL_DEVICE = process.platform === "win32" ? "NUL" : "/dev/null";
+
+// `#include <...>` directories of `compiler` for lang "c" / "c++", in search order
+function searchChain(compiler, lang, flags = []) {
+  return new Promise((resolve, reject) => {
+    execFile(compiler, [...flags, "-x", lang, "-E", "-v", NULL_DEVICE], { timeout: 30_000, windowsHide: true }, (e, _, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      const m = /#include <\.\.\.> search starts here:\r?\n([^]*?)End of search list/.exec(err);
+      if (!m) return reject(new Error("no include search list in " + path.basename(compiler) + " -v output"));
+      resolve(m[1].split(/\r?\n/).map(s => s.trim()).filter(Boolean).map(d => path.resolve(d.replace(/ \(framework directory\)$/, ""))));
+    });
+  });
+}
+
+const manifests = new Map(); // map dir -> manifest (null: none)
+
+function load(dir) {
+  if (!manifests.has(dir)) {
+    try {
+      manifests.set(dir, JSON.parse(fs.readFileSync(path.join(dir, "manifest.json"), "utf8")));
+    } catch (_) {
+      manifests.set(dir, null);
+    }
+  }
+  return manifests.get(dir);
+}
+
+// Compiler flags that put the map in front of the search chain; none without
+// a map, for a map built by another toolchain, or for -m32 (other headers).
+function flags(lang, extra = []) {
+  const dir = mapDir();
+  const m = load(dir);
+  if (!m || !m.langs[lang] || m.toolchain !== toolchainId() || extra.includes("-m32")) return [];
+  return ["-isystem", path.join(dir, lang)];
+}
+
+module.exports = { searchChain, flags };
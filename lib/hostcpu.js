@@ -0,0 +1,117 @@
+// Host CPU detection for the "host" build profile. The bundled gcc is
+// configured --with-arch=core2, so by default nothing above SSSE3 is used.
+// `gcc -march=native` tells us what this machine has; the result is mapped to
+// an x86-64 psABI level (v2/v3/v4) and cached in temp/host-cpu.json until the
+// CPU model or the toolchain changes.
+const { execFile } = require("child_process");
+const crypto = require("crypto");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const install = require("./install");
+
+const gcc = () => path.join(install.dir("toolchain"), "bin", "gcc.exe");
+const GUARD_SRC = path.join(__dirname, "isa-guard.c");
+const NULL_DEVICE = process.platform === "win32" ? "NUL" : "/dev/null";
+
+// predefined macros required by each level (x86-64 psABI); LAHF/SAHF has no macro
+const LEVELS = [
+  ["x86-64-v2", ["__SSE3__", "__SSSE3__", "__SSE4_1__", "__SSE4_2__", "__POPCNT__", "__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16"]],
+  ["x86-64-v3", ["__AVX__", "__AVX2__", "__BMI__", "__BMI2__", "__F16C__", "__FMA__", "__LZCNT__", "__MOVBE__", "__XSAVE__"]],
+  ["x86-64-v4", ["__AVX512F__", "__AVX512BW__", "__AVX512CD__", "__AVX512DQ__", "__AVX512VL__"]]
+];
+
+function run(exe, args) {
+  return new Promise((resolve, reject) => {
+    execFile(exe, args, { maxBuffer: 4 * 1024 * 1024, timeout: 30_000, windowsHide: true }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve(out);
+    });
+  });
+}
+
+// changes whenever the compiler is replaced or rebuilt. Whole milliseconds,
+// cut off like the install manifest's mtimes, so the share's compiler and
+// its local copy (lib/install.js) have the same id.
+function toolchainId(compiler = gcc()) {
+  try {
+    const st = fs.statSync(compiler);
+    return `${st.size}-${Math.floor(st.mtimeMs)}`;
+  } catch (_) {
+    return "unknown";
+  }
+}
+
+// Content hash of the driver, the compilers proper and the assembler: two
+// machines with the same digest build the same objects (shared compile cache,
+// remote compile). Computed once per toolchainId().
+let digest = null;
+async function toolchainDigest() {
+  const id = toolchainId();
+  if (digest && digest.id === id) return digest.value;
+  const files = [gcc()];
+  for (const prog of ["cc1", "cc1plus", "as"]) files.push((await run(gcc(), ["-print-prog-name=" + prog])).trim());
+  const h = crypto.createHash("sha256");
+  for (const file of files) {
+    h.update(path.basename(file) + "\0");
+    try {
+      for await (const chunk of fs.createReadStream(file)) h.update(chunk);
+    } catch (_) {
+      h.update("missing\0");
+    }
+  }
+  digest = { id, value: h.digest("hex") };
+  return digest.value;
+}
+
+// highest level whose features (and all lower levels' features) are present
+function levelOf(macros) {
+  let level = "x86-64";
+  for (const [name, required] of LEVELS) {
+    if (!required.every(m => macros.has(m))) break;
+    level = name;
+  }
+  return level;
+}
+
+let detected = null;
+
+// -> { model, toolchain, march, level, features }
+async function detect(dir) {
+  const model = os.cpus()[0] ? os.cpus()[0].model.trim() : "unknown";
+  const toolchain = toolchainId();
+  if (detected && detected.model === model && detected.toolchain === toolchain) return detected;
+  const cacheFile = path.join(dir, "host-cpu.json");
+  try {
+    const cached = JSON.parse(fs.readFileSync(cacheFile, "utf8"));
+    if (cached.model === model && cached.toolchain === toolchain) return (detected = cached);
+  } catch (_) {}
+
+  const [defines, target] = await Promise.all([
+    run(gcc(), ["-march=native", "-dM", "-E", "-x", "c", NULL_DEVICE]),
+    run(gcc(), ["-march=native", "-Q", "--help=target"])
+  ]);
+  const macros = new Set([...defines.matchAll(/^#define (\w+) /gm)].map(m => m[1]));
+  const march = (/^\s*-march=\s+(\S+)/m.exec(target) || [])[1] || "native";
+  detected = {
+    model,
+    toolchain,
+    march,
+    level: levelOf(macros),
+    features: LEVELS.flatMap(([, req]) => req).filter(m => macros.has(m))
+      .map(m => (m === "__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16" ? "cx16" : m.replace(/^__|__$/g, "").toLowerCase()))
+  };
+  fs.writeFileSync(cacheFile, JSON.stringify(detected, null, 1));
+  return detected;
+}
+
+// Start-up ISA check for `level`, built once per level at the baseline arch.
+// Returns the object file to add to the link.
+async function guardObject(dir, level) {
+  const obj = path.join(dir, `isa-guard-${level}.o`);
+  const stale = !fs.existsSync(obj) || fs.statSync(obj).mtimeMs < fs.statSync(GUARD_SRC).mtimeMs;
+  if (stale) await run(gcc(), ["-O2", "-c", `-DISA_LEVEL="${level}"`, "-o", obj, GUARD_SRC]);
+  return obj;
+}
+
+module.exports = { LEVELS: LEVELS.map(([name]) => name), toolchainId, toolchainDigest, levelOf, detect, guardObject };
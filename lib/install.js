@@ -0,0 +1,177 @@
+// Install layout.
+//
+// A normal install runs everything from the app folder and keeps scratch
+// files in <app>/temp. A shared install is one read-only app folder on a file
+// share used by many lab seats, enabled by shared-install.json next to
+// main.js (or LANGUAGGIFY_SHARED=1):
+//   - every write goes to a per-user local directory (workDir);
+//   - the large read-only trees (toolchain, Python, QuickJS, Monaco) are
+//     copied to a per-machine local cache the first time they are used and
+//     run from there; until a copy is complete the share is used directly.
+//
+// scripts/install-manifest.js writes install-manifest/ on the share: the
+// sha256 of every file of each tree plus an index of tree digests. A local
+// copy lives in <cacheDir>/<tree>-<digest>; it is filled from the share (or,
+// for unchanged files, from the previous local version), every file is
+// hashed while it is copied, and the directory is renamed into place only
+// when complete, so a seat never runs a partial or stale copy.
+//
+// shared-install.json: { "workDir": "...", "cacheDir": "..." }, both
+// optional; %VAR% is expanded. Other sections (compileCache) are read by the
+// features they configure.
+const crypto = require("crypto");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const { pipeline } = require("stream/promises");
+
+const APP = path.join(__dirname, "..");
+const MANIFEST_DIR = path.join(APP, "install-manifest");
+const LOCAL_MANIFEST = ".install-manifest.json";
+const TREES = { toolchain: "c c++", python: "py", quickjs: "quickjs", monaco: "monaco", "monaco-min": "monaco-min" };
+
+function readJson(file) {
+  try {
+    return JSON.parse(fs.readFileSync(file, "utf8"));
+  } catch (_) {
+    return null;
+  }
+}
+
+const expand = p => p && path.resolve(p.replace(/%(\w+)%/g, (m, v) => process.env[v] || m));
+
+const config = readJson(path.join(APP, "shared-install.json"));
+const shared = !!config || process.env.LANGUAGGIFY_SHARED === "1";
+const workDir = shared
+  ? expand(config && config.workDir) || path.join(process.env.LOCALAPPDATA || path.join(os.homedir(), ".cache"), "Languaggify")
+  : path.join(APP, "temp");
+
+// per-machine cache; per-user when the machine-wide location is not writable
+let cacheRoot;
+function cacheDir() {
+  if (!cacheRoot) {
+    const want = expand(config && config.cacheDir) || path.join(process.env.ProgramData || os.tmpdir(), "Languaggify", "cache");
+    try {
+      fs.mkdirSync(want, { recursive: true });
+      const probe = path.join(want, `.probe-${process.pid}`);
+      fs.writeFileSync(probe, "");
+      fs.rmSync(probe);
+      cacheRoot = want;
+    } catch (_) {
+      cacheRoot = path.join(workDir, "cache");
+      fs.mkdirSync(cacheRoot, { recursive: true });
+    }
+  }
+  return cacheRoot;
+}
+
+let index; // tree -> digest
+function digestOf(tree) {
+  if (index === undefined) index = readJson(path.join(MANIFEST_DIR, "index.json"));
+  return index && index[tree];
+}
+
+const localName = new RegExp(`^(${Object.keys(TREES).join("|")})-([0-9a-f]{16})$`);
+const localDir = (tree, digest) => path.join(cacheDir(), `${tree}-${digest.slice(0, 16)}`);
+
+const local = new Map();   // tree -> warm local copy
+const warming = new Map(); // tree -> promise of the copy in progress
+
+// Directory to use for `tree` right now. In a shared install the first call
+// starts the local copy and the share is returned until it is ready.
+function dir(tree) {
+  const shareDir = path.join(APP, TREES[tree]);
+  if (!shared) return shareDir;
+  if (local.has(tree)) return local.get(tree);
+  const digest = digestOf(tree);
+  if (!digest) return shareDir; // not in the manifest: always used from the share
+  const d = localDir(tree, digest);
+  if (fs.existsSync(d)) {
+    local.set(tree, d);
+    return d;
+  }
+  warm(tree).catch(err => console.error(`[install] local copy of ${tree} failed: ${err.message}`));
+  return shareDir;
+}
+
+// Resolves with the local copy of `tree` once it is complete (the app folder
+// itself in a normal install).
+function warm(tree) {
+  if (!shared || !digestOf(tree)) return Promise.resolve(path.join(APP, TREES[tree]));
+  if (local.has(tree)) return Promise.resolve(local.get(tree));
+  if (!warming.has(tree)) {
+    warming.set(tree, copyTree(tree).then(d => {
+      local.set(tree, d);
+      warming.delete(tree);
+      return d;
+    }, err => {
+      warming.delete(tree);
+      throw err;
+    }));
+  }
+  return warming.get(tree);
+}
+
+async function copyHashed(from, to) {
+  const h = crypto.createHash("sha256");
+  const input = fs.createReadStream(from);
+  input.on("data", chunk => h.update(chunk));
+  await pipeline(input, fs.createWriteStream(to));
+  return h.digest("hex");
+}
+
+// complete local copies of `tree`, newest first
+function localCopies(tree) {
+  let names = [];
+  try { names = fs.readdirSync(cacheDir()); } catch (_) {}
+  return names.map(n => localName.exec(n)).filter(m => m && m[1] === tree)
+    .map(m => path.join(cacheDir(), m[0]))
+    .sort((a, b) => fs.statSync(b).mtimeMs - fs.statSync(a).mtimeMs);
+}
+
+async function copyTree(tree) {
+  const digest = digestOf(tree);
+  const dest = localDir(tree, digest);
+  if (fs.existsSync(dest)) return dest;
+  const manifest = readJson(path.join(MANIFEST_DIR, tree + ".json"));
+  if (!manifest || manifest.digest !== digest) throw new Error(`install-manifest/${tree}.json does not match index.json`);
+
+  // files unchanged since the previous local version are copied from there
+  const previous = localCopies(tree)[0];
+  const old = new Map(((previous && readJson(path.join(previous, LOCAL_MANIFEST))) || { files: [] }).files.map(f => [f.path, f.sha256]));
+
+  const shareDir = path.join(APP, TREES[tree]);
+  const tmp = `${dest}.partial-${process.pid}`;
+  fs.rmSync(tmp, { recursive: true, force: true });
+  try {
+    for (const f of manifest.files) {
+      const to = path.join(tmp, f.path);
+      fs.mkdirSync(path.dirname(to), { recursive: true });
+      if (f.link) {
+        // hard link on the share (the header map): keep it one file locally
+        try { fs.linkSync(path.join(tmp, f.link), to); } catch (_) { fs.copyFileSync(path.join(tmp, f.link), to); }
+        continue;
+      }
+      const from = old.get(f.path) === f.sha256 ? path.join(previous, f.path) : path.join(shareDir, f.path);
+      if (await copyHashed(from, to) !== f.sha256) throw new Error(`${TREES[tree]}/${f.path} does not match the install manifest`);
+      // toolchain ids and #pragma once compare mtimes (whole ms on both sides)
+      fs.utimesSync(to, f.mtime / 1000, f.mtime / 1000);
+    }
+    fs.writeFileSync(path.join(tmp, LOCAL_MANIFEST), JSON.stringify(manifest));
+    fs.renameSync(tmp, dest);
+  } catch (err) {
+    fs.rmSync(tmp, { recursive: true, force: true });
+    if (!fs.existsSync(dest)) throw err; // otherwise another user on this seat finished first
+  }
+  // versions before the previous one (a session still running the previous
+  // version keeps it) and copies abandoned by a crashed session
+  for (const d of localCopies(tree).filter(d => d !== dest).slice(1)) fs.rm(d, { recursive: true, force: true }, () => {});
+  const abandoned = new RegExp(`^${tree}-[0-9a-f]{16}\\.partial-\\d+$`);
+  for (const n of fs.readdirSync(cacheDir()).filter(n => abandoned.test(n))) {
+    const d = path.join(cacheDir(), n);
+    if (Date.now() - fs.statSync(d).mtimeMs > 24 * 3600_000) fs.rm(d, { recursive: true, force: true }, () => {});
+  }
+  return dest;
+}
+
+module.exports = { APP, TREES, MANIFEST_DIR, config: config || {}, shared, workDir, cacheDir, digest: digestOf, dir, warm };
@@ -0,0 +1,26 @@
+/*
+ * Start-up check linked into host-tuned builds (lib/hostcpu.js). The object
+ * is compiled for the toolchain's baseline architecture with ISA_LEVEL set to
+ * the level the program was built for (x86-64-v2/v3/v4); on a CPU without it
+ * the program stops with a message instead of an illegal-instruction crash
+ * somewhere later.
+ *
+ * Priority 101 runs before default-priority constructors, so no host-tuned
+ * static initialiser has run yet.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef ISA_LEVEL
+#error "build with -DISA_LEVEL=\"x86-64-vN\""
+#endif
+
+__attribute__((constructor(101))) static void isa_guard(void)
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports(ISA_LEVEL))
+		return;
+	fputs("This program was built for " ISA_LEVEL " (host-tuned profile) and this CPU does not support it.\n"
+	      "Rebuild it with the Default build profile to run it here.\n", stderr);
+	exit(3);
+}
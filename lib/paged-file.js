@@ -0,0 +1,262 @@
+// Large files (data sets for lessons) without loading them: open-file hands
+// anything over LARGE_FILE_BYTES to a paged, read-only viewer
+// (renderer/pagedview.js) backed by this class.
+//
+// Opening streams the file once in 1 MB blocks to build a sparse line index:
+// the byte offset of every INDEX_EVERY-th line, a few thousand numbers even
+// for a 200 MB CSV. Pages are then read with positioned reads from the
+// nearest indexed line, so memory and latency do not grow with the file.
+// Pages can be read while the index is still being built.
+//
+// A range of lines can be edited in the editor; replaceLines() streams the
+// file into a temp copy with the range swapped and renames it into place,
+// shifting the index instead of rebuilding it.
+const fs = require("fs");
+const path = require("path");
+
+const LARGE_FILE_BYTES = 16 * 1024 * 1024;
+const INDEX_EVERY = 1000;
+const BLOCK = 1024 * 1024;
+const MAX_LINE_CHARS = 10_000; // longer lines are cut in the viewer
+const MAX_PAGE_BYTES = 4 * 1024 * 1024;
+const MAX_EDIT_BYTES = 8 * 1024 * 1024;
+
+class PagedFile {
+  constructor(file) {
+    this.file = file;
+    this.lines = [0];    // line numbers of the checkpoints
+    this.offsets = [0];  // their byte offsets
+    this.total = 0;      // lines counted so far
+    this.complete = false;
+    this.crlf = false;
+    this.error = null;
+    this.closed = false;
+    this.stat = fs.statSync(file);
+    this.indexed = this.index().catch(err => {
+      this.error = err.message;
+    });
+  }
+
+  async index() {
+    const fh = await fs.promises.open(this.file, "r");
+    const buf = Buffer.allocUnsafe(BLOCK);
+    let pos = 0;
+    let line = 0;
+    let last = -1; // last byte of the previous block
+    try {
+      for (;;) {
+        if (this.closed) return; // the viewer is gone: stop scanning
+        const { bytesRead } = await fh.read(buf, 0, BLOCK, pos);
+        if (!bytesRead) break;
+        for (let i = buf.indexOf(10, 0); i !== -1 && i < bytesRead; i = buf.indexOf(10, i + 1)) {
+          if (line === 0) this.crlf = (i ? buf[i - 1] : last) === 13;
+          line++;
+          if (line % INDEX_EVERY === 0) {
+            this.lines.push(line);
+            this.offsets.push(pos + i + 1);
+          }
+        }
+        last = buf[bytesRead - 1];
+        pos += bytesRead;
+        this.total = line;
+      }
+    } finally {
+      await fh.close();
+    }
+    // a last line without a line break still counts
+    this.total = line + (pos > 0 && last !== 10 ? 1 : 0);
+    this.complete = true;
+  }
+
+  // stops the index scan; the object is not used afterwards
+  close() {
+    this.closed = true;
+  }
+
+  info() {
+    return { file: this.file, size: this.stat.size, total: this.total, complete: this.complete, crlf: this.crlf, error: this.error };
+  }
+
+  // offset of the closest indexed line at or before `line`
+  checkpoint(line) {
+    let lo = 0;
+    let hi = this.lines.length - 1;
+    while (lo < hi) {
+      const mid = (lo + hi + 1) >> 1;
+      if (this.lines[mid] <= line) lo = mid;
+      else hi = mid - 1;
+    }
+    return { line: this.lines[lo], offset: this.offsets[lo] };
+  }
+
+  // Calls `onLine(bytes, offset)` for each line from `start` (0-based) until it
+  // returns false or the file ends. `bytes` excludes the line break.
+  async scan(start, onLine) {
+    const fh = await fs.promises.open(this.file, "r");
+    try {
+      let { line, offset } = this.checkpoint(start);
+      const buf = Buffer.allocUnsafe(BLOCK);
+      let carry = null;
+      let carryOffset = offset;
+      for (;;) {
+        const { bytesRead } = await fh.read(buf, 0, BLOCK, offset);
+        let from = 0;
+        for (let i = buf.indexOf(10, 0); i !== -1 && i < bytesRead; i = buf.indexOf(10, i + 1)) {
+          let bytes = buf.subarray(from, i);
+          if (carry) bytes = Buffer.concat([carry, bytes]);
+          const at = carry ? carryOffset : offset + from;
+          carry = null;
+          if (line >= start && onLine(bytes, at) === false) return;
+          line++;
+          from = i + 1;
+        }
+        if (!bytesRead) {
+          if (carry && carry.length && line >= start) onLine(carry, carryOffset);
+          return;
+        }
+        // partial line: keep it (bounded, so one huge line cannot take all memory)
+        if (from < bytesRead) {
+          if (!carry) carryOffset = offset + from;
+          const rest = buf.subarray(from, bytesRead);
+          carry = carry ? Buffer.concat([carry, rest]) : Buffer.from(rest);
+          if (carry.length > MAX_EDIT_BYTES) carry = carry.subarray(0, MAX_EDIT_BYTES);
+        }
+        offset += bytesRead;
+      }
+    } finally {
+      await fh.close();
+    }
+  }
+
+  // -> { start, lines: [string], cut: [index of lines cut to MAX_LINE_CHARS], ...info() }
+  async read(start, count) {
+    const lines = [];
+    const cut = [];
+    let bytes = 0;
+    await this.scan(start, b => {
+      let text = decode(b, lines.length === 0 && start === 0);
+      if (text.length > MAX_LINE_CHARS) {
+        text = text.slice(0, MAX_LINE_CHARS);
+        cut.push(lines.length);
+      }
+      lines.push(text);
+      bytes += b.length;
+      return lines.length < count && bytes < MAX_PAGE_BYTES;
+    });
+    return { start, lines, cut, ...this.info() };
+  }
+
+  // first line at or after `from` containing `text` (case-insensitive), or -1
+  async find(text, from) {
+    const needle = text.toLowerCase();
+    let line = from;
+    let found = -1;
+    await this.scan(from, b => {
+      if (decode(b).toLowerCase().includes(needle)) {
+        found = line;
+        return false;
+      }
+      line++;
+      return true;
+    });
+    return found;
+  }
+
+  // Lines [start, end) as one string (line breaks: \n) for the editor.
+  async text(start, end) {
+    const lines = [];
+    let bytes = 0;
+    await this.scan(start, b => {
+      bytes += b.length + 1;
+      if (bytes > MAX_EDIT_BYTES) throw new Error(`lines ${start + 1}-${end} are too long to edit (over ${MAX_EDIT_BYTES >> 20} MB)`);
+      lines.push(decode(b, start + lines.length === 0));
+      return start + lines.length < end;
+    });
+    return lines.join("\n");
+  }
+
+  // Replace lines [start, end) with `text` by streaming a copy of the file;
+  // resolves with the new number of lines in the range.
+  async replaceLines(start, end, text) {
+    await this.indexed;
+    const st = fs.statSync(this.file);
+    if (st.size !== this.stat.size || st.mtimeMs !== this.stat.mtimeMs) throw new Error(path.basename(this.file) + " changed on disk; reopen it");
+    // byte range of the lines
+    let from = -1;
+    let to = st.size;
+    let line = start;
+    await this.scan(start, (b, at) => {
+      if (line === start) from = at;
+      if (line === end) {
+        to = at;
+        return false;
+      }
+      line++;
+      return true;
+    });
+    if (from < 0) from = st.size;
+    const eol = this.crlf ? "\r\n" : "\n";
+    const lines = text === "" ? [] : text.split(/\r\n|\r|\n/);
+    const bom = start === 0 && (await readBytes(this.file, 0, 3)).equals(BOM) ? BOM : Buffer.alloc(0);
+    // the range's last line keeps a line break unless it was the end of the file without one
+    const lastBreak = to < st.size || (st.size > 0 && (await readBytes(this.file, st.size - 1, 1))[0] === 10);
+    const insert = Buffer.concat([bom, Buffer.from(lines.join(eol) + (lastBreak && lines.length ? eol : ""), "utf8")]);
+
+    const tmp = `${this.file}.${process.pid}.tmp`;
+    const out = await fs.promises.open(tmp, "w");
+    const input = await fs.promises.open(this.file, "r");
+    try {
+      await copyRange(input, out, 0, from);
+      await out.write(insert);
+      await copyRange(input, out, to, st.size);
+      await out.sync();
+    } finally {
+      await input.close();
+      await out.close();
+    }
+    await fs.promises.rename(tmp, this.file);
+
+    // shift the index past the range, drop checkpoints inside it
+    const dLines = lines.length - (end - start);
+    const dBytes = insert.length - (to - from);
+    const keep = this.lines.map((l, i) => i).filter(i => this.lines[i] <= start || this.lines[i] >= end);
+    this.offsets = keep.map(i => (this.lines[i] >= end && this.lines[i] > start ? this.offsets[i] + dBytes : this.offsets[i]));
+    this.lines = keep.map(i => (this.lines[i] >= end && this.lines[i] > start ? this.lines[i] + dLines : this.lines[i]));
+    this.total += dLines;
+    this.stat = fs.statSync(this.file);
+    return lines.length;
+  }
+}
+
+const BOM = Buffer.from([0xef, 0xbb, 0xbf]);
+
+// a line's bytes as text: no trailing \r, no BOM on the first line
+function decode(bytes, first) {
+  let text = bytes.toString("utf8");
+  if (text.endsWith("\r")) text = text.slice(0, -1);
+  if (first && text.charCodeAt(0) === 0xfeff) text = text.slice(1);
+  return text;
+}
+
+async function readBytes(file, pos, n) {
+  const fh = await fs.promises.open(file, "r");
+  try {
+    const buf = Buffer.alloc(n);
+    const { bytesRead } = await fh.read(buf, 0, n, pos);
+    return buf.subarray(0, bytesRead);
+  } finally {
+    await fh.close();
+  }
+}
+
+async function copyRange(input, out, from, to) {
+  const buf = Buffer.allocUnsafe(BLOCK);
+  for (let pos = from; pos < to;) {
+    const { bytesRead } = await input.read(buf, 0, Math.min(BLOCK, to - pos), pos);
+    if (!bytesRead) break;
+    await out.write(buf.subarray(0, bytesRead));
+    pos += bytesRead;
+  }
+}
+
+module.exports = { PagedFile, LARGE_FILE_BYTES };
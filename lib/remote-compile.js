@@ -0,0 +1,119 @@
+// Remote compile for the run-code C/C++ path: the seat preprocesses, one of
+// the lab's build servers (scripts/compile-server.js, the same bundled
+// toolchain) turns the preprocessed source into an object file, and the seat
+// links it. Only the compile proper moves; headers, the guard object and the
+// libraries never leave the seat.
+//
+// Servers are tried cheapest first: estimated wait = (jobs this seat has
+// running there + the queue the server last reported + 1) x its recent
+// compile time. A server that is away, busy (503) or runs a different
+// toolchain (409) is skipped for a while and the next one is tried. When
+// none answers within `timeoutMs`, compile() resolves null and the caller
+// compiles locally; compile errors reject with the diagnostics like a local
+// compile would.
+const http = require("http");
+const https = require("https");
+
+const AWAY_MS = 30_000;             // unreachable or timed out
+const MISMATCH_MS = 10 * 60_000;    // different toolchain
+const BUSY_MS = 2000;
+
+class CompileError extends Error {}
+
+class RemoteCompiler {
+  // servers: ["http://host:port", ...]
+  constructor(servers, { timeoutMs = 10_000, connectMs = 1000 } = {}) {
+    this.servers = servers.map(url => ({
+      url: url.replace(/\/+$/, ""), active: 0, queued: 0, ms: 1000, jobs: 0, failures: 0, skipUntil: 0, reason: null
+    }));
+    this.timeoutMs = timeoutMs;
+    this.connectMs = connectMs;
+  }
+
+  // `list`: array or comma-separated string of server URLs; null when empty
+  static open(list, opts = {}) {
+    const servers = (Array.isArray(list) ? list : String(list || "").split(",")).map(s => s.trim()).filter(Boolean);
+    return servers.length ? new RemoteCompiler(servers, opts) : null;
+  }
+
+  // job: { lang: "c" | "c++", flags, source (preprocessed), toolchain (hostcpu.toolchainDigest) }
+  // -> { object: Buffer, warnings, server, ms } or null (compile locally)
+  async compile(job) {
+    const deadline = Date.now() + this.timeoutMs;
+    const tried = new Set();
+    for (;;) {
+      const now = Date.now();
+      const s = this.servers.filter(s => !tried.has(s) && s.skipUntil <= now)
+        .sort((a, b) => (a.active + a.queued + 1) * a.ms - (b.active + b.queued + 1) * b.ms)[0];
+      if (!s || now >= deadline) return null;
+      tried.add(s);
+      s.active++;
+      const started = Date.now();
+      try {
+        const res = await this.post(s, job, deadline - now);
+        s.ms = 0.7 * s.ms + 0.3 * (Date.now() - started);
+        s.jobs++;
+        return { ...res, server: s.url, ms: Date.now() - started };
+      } catch (err) {
+        if (err instanceof CompileError) throw err;
+        s.failures++;
+        s.reason = err.message;
+        s.skipUntil = Date.now() + (err.status === 409 ? MISMATCH_MS : err.status === 503 ? BUSY_MS : AWAY_MS);
+      } finally {
+        s.active--;
+      }
+    }
+  }
+
+  post(s, job, timeoutMs) {
+    const body = Buffer.from(job.source, "utf8");
+    const mod = s.url.startsWith("https:") ? https : http;
+    return new Promise((resolve, reject) => {
+      const fail = (message, status) => reject(Object.assign(new Error(message), { status }));
+      const req = mod.request(s.url + "/compile", {
+        method: "POST",
+        headers: {
+          "Content-Type": "text/plain; charset=utf-8",
+          "Content-Length": body.length,
+          "X-Lang": job.lang,
+          "X-Flags": JSON.stringify(job.flags),
+          "X-Toolchain": job.toolchain
+        }
+      }, res => {
+        const chunks = [];
+        res.on("data", c => chunks.push(c));
+        res.on("error", err => fail(err.message));
+        res.on("end", () => {
+          clearTimeout(timer);
+          const data = Buffer.concat(chunks);
+          s.queued = +res.headers["x-queued"] || 0;
+          if (res.statusCode === 200) return resolve({ object: data, warnings: decodeURIComponent(res.headers["x-warnings"] || "") });
+          if (res.statusCode === 422) return reject(new CompileError(data.toString("utf8").trim()));
+          fail(`${s.url}: HTTP ${res.statusCode} ${data.toString("utf8").trim()}`, res.statusCode);
+        });
+      });
+      // a server that does not accept the connection quickly is away; one
+      // that accepted the job gets the rest of the budget
+      const timer = setTimeout(() => req.destroy(new Error(`${s.url} timed out`)), timeoutMs);
+      req.setTimeout(this.connectMs, () => {
+        if (!req.socket || req.socket.connecting) req.destroy(new Error(`${s.url} did not answer`));
+      });
+      req.on("error", err => {
+        clearTimeout(timer);
+        fail(err.message);
+      });
+      req.end(body);
+    });
+  }
+
+  // per-server state for the cache/build panel
+  status() {
+    const now = Date.now();
+    return this.servers.map(s => ({
+      url: s.url, jobs: s.jobs, failures: s.failures, ms: Math.round(s.ms),
+      state: s.skipUntil > now ? s.reason : "ok"
+    }));
+  }
+}
+
+module.exports = { RemoteCompiler, CompileError };
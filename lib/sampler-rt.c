@@ -0,0 +1,249 @@
+/*
+ * Stack-sampling runtime linked into programs started by the "Sample" action
+ * (see lib/sampler.js). Compiles as C or C++.
+ *
+ * Windows: a helper thread suspends the main thread about every millisecond,
+ * unwinds it with RtlVirtualUnwind and resumes it. Samples taken while the
+ * thread had not used any cycles since the last one (blocked on I/O, sleeping)
+ * are skipped, so the profile shows CPU time.
+ * Elsewhere: ITIMER_PROF + SIGPROF and backtrace().
+ *
+ * Raw addresses go into a static buffer (nothing is allocated while the
+ * target is stopped) and are written out at exit as module-relative offsets:
+ *
+ *   # samples interval_us=1000 count=N dropped=D
+ *   m <id> <main|lib> <path>
+ *   s <id>+<hex offset> ...        (one line per sample, leaf frame first)
+ *
+ * The output file is $LANGUAGGIFY_SAMPLES, or samples.out in the working dir.
+ */
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* dladdr */
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LGFY_INTERVAL_US 1000
+#define LGFY_MAX_DEPTH 64
+#define LGFY_BUF_SLOTS (1u << 21)
+#define LGFY_MAX_MODULES 128
+
+/* per sample: depth, then `depth` addresses */
+static uintptr_t lgfy_buf[LGFY_BUF_SLOTS];
+static volatile size_t lgfy_used;
+static volatile size_t lgfy_count, lgfy_dropped;
+static volatile int lgfy_running;
+
+static void lgfy_record(const uintptr_t *frames, size_t n)
+{
+	if (!n) return;
+	if (lgfy_used + n + 1 > LGFY_BUF_SLOTS) {
+		lgfy_dropped++;
+		return;
+	}
+	lgfy_buf[lgfy_used] = n;
+	memcpy(&lgfy_buf[lgfy_used + 1], frames, n * sizeof(uintptr_t));
+	lgfy_used += n + 1;
+	lgfy_count++;
+}
+
+/* module table built at dump time */
+struct lgfy_module { uintptr_t base; int main; char path[512]; };
+static struct lgfy_module lgfy_modules[LGFY_MAX_MODULES];
+static int lgfy_nmodules;
+
+static int lgfy_module_add(uintptr_t base, int is_main, const char *path)
+{
+	int i;
+	for (i = 0; i < lgfy_nmodules; i++)
+		if (lgfy_modules[i].base == base) return i;
+	if (lgfy_nmodules == LGFY_MAX_MODULES) return -1;
+	lgfy_modules[i].base = base;
+	lgfy_modules[i].main = is_main;
+	strncpy(lgfy_modules[i].path, path ? path : "?", sizeof lgfy_modules[i].path - 1);
+	return lgfy_nmodules++;
+}
+
+#ifdef _WIN32
+#include <windows.h>
+
+static HANDLE lgfy_target, lgfy_thread;
+
+static int lgfy_module_of(uintptr_t addr)
+{
+	HMODULE h;
+	char path[512];
+	if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)addr, &h))
+		return -1;
+	if (!GetModuleFileNameA(h, path, sizeof path)) strcpy(path, "?");
+	return lgfy_module_add((uintptr_t)h, h == GetModuleHandleA(NULL), path);
+}
+
+static size_t lgfy_unwind(CONTEXT *ctx, uintptr_t *frames)
+{
+	size_t n = 0;
+#if defined(_M_X64) || defined(__x86_64__)
+	while (n < LGFY_MAX_DEPTH && ctx->Rip) {
+		DWORD64 image_base;
+		PRUNTIME_FUNCTION fn;
+		frames[n++] = (uintptr_t)ctx->Rip;
+		fn = RtlLookupFunctionEntry(ctx->Rip, &image_base, NULL);
+		if (fn) {
+			PVOID handler_data;
+			DWORD64 establisher;
+			RtlVirtualUnwind(UNW_FLAG_NHANDLER, image_base, ctx->Rip, fn, ctx, &handler_data, &establisher, NULL);
+		} else {
+			/* leaf function without unwind data: return address is on top */
+			ctx->Rip = *(DWORD64 *)ctx->Rsp;
+			ctx->Rsp += 8;
+		}
+	}
+#else
+	/* 32-bit: follow the frame-pointer chain inside the live stack */
+	uintptr_t fp = ctx->Ebp, sp = ctx->Esp;
+	frames[n++] = ctx->Eip;
+	while (n < LGFY_MAX_DEPTH && fp >= sp && (fp & 3) == 0 && fp - sp < (16u << 20)) {
+		uintptr_t next = ((uintptr_t *)fp)[0], ret = ((uintptr_t *)fp)[1];
+		if (!ret) break;
+		frames[n++] = ret;
+		if (next <= fp) break;
+		fp = next;
+	}
+#endif
+	return n;
+}
+
+static DWORD WINAPI lgfy_loop(LPVOID arg)
+{
+	typedef UINT (WINAPI *period_fn)(UINT);
+	HMODULE winmm = LoadLibraryA("winmm.dll");
+	period_fn begin = winmm ? (period_fn)(void *)GetProcAddress(winmm, "timeBeginPeriod") : NULL;
+	period_fn end = winmm ? (period_fn)(void *)GetProcAddress(winmm, "timeEndPeriod") : NULL;
+	ULONG64 last_cycles = 0;
+	uintptr_t frames[LGFY_MAX_DEPTH];
+	(void)arg;
+	if (begin) begin(1);
+	while (lgfy_running) {
+		CONTEXT ctx;
+		ULONG64 cycles = 0;
+		size_t n = 0;
+		Sleep(1);
+		if (SuspendThread(lgfy_target) == (DWORD)-1) break;
+		QueryThreadCycleTime(lgfy_target, &cycles);
+		if (cycles != last_cycles) {
+			memset(&ctx, 0, sizeof ctx);
+			ctx.ContextFlags = CONTEXT_FULL;
+			if (GetThreadContext(lgfy_target, &ctx)) n = lgfy_unwind(&ctx, frames);
+		}
+		ResumeThread(lgfy_target);
+		if (cycles != last_cycles) lgfy_record(frames, n);
+		last_cycles = cycles;
+	}
+	if (end) end(1);
+	return 0;
+}
+
+static void lgfy_start(void)
+{
+	DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &lgfy_target,
+	                THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, 0);
+	lgfy_running = 1;
+	lgfy_thread = CreateThread(NULL, 64 * 1024, lgfy_loop, NULL, 0, NULL);
+}
+
+static void lgfy_stop(void)
+{
+	lgfy_running = 0;
+	if (lgfy_thread) WaitForSingleObject(lgfy_thread, 1000);
+}
+
+#else
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+
+static int lgfy_module_of(uintptr_t addr)
+{
+	static Dl_info self;
+	Dl_info info;
+	if (!self.dli_fbase) dladdr((void *)&lgfy_module_of, &self);
+	if (!dladdr((void *)addr, &info)) return -1;
+	return lgfy_module_add((uintptr_t)info.dli_fbase, info.dli_fbase == self.dli_fbase, info.dli_fname);
+}
+
+static void lgfy_on_prof(int sig)
+{
+	void *frames[LGFY_MAX_DEPTH + 2];
+	int n = backtrace(frames, LGFY_MAX_DEPTH + 2);
+	(void)sig;
+	/* drop this handler and the signal trampoline */
+	if (n > 2 && lgfy_running) lgfy_record((uintptr_t *)frames + 2, (size_t)(n - 2));
+}
+
+static void lgfy_start(void)
+{
+	void *warm[1];
+	struct itimerval it;
+	backtrace(warm, 1); /* loads the unwinder outside the signal handler */
+	signal(SIGPROF, lgfy_on_prof);
+	lgfy_running = 1;
+	it.it_interval.tv_sec = 0;
+	it.it_interval.tv_usec = LGFY_INTERVAL_US;
+	it.it_value = it.it_interval;
+	setitimer(ITIMER_PROF, &it, NULL);
+}
+
+static void lgfy_stop(void)
+{
+	struct itimerval off;
+	memset(&off, 0, sizeof off);
+	setitimer(ITIMER_PROF, &off, NULL);
+	lgfy_running = 0;
+}
+#endif
+
+static void lgfy_dump(void)
+{
+	const char *out = getenv("LANGUAGGIFY_SAMPLES");
+	FILE *f;
+	size_t i, k;
+	int m;
+	lgfy_stop();
+	f = fopen(out && *out ? out : "samples.out", "w");
+	if (!f) return;
+	fprintf(f, "# samples interval_us=%d count=%lu dropped=%lu\n", LGFY_INTERVAL_US,
+	        (unsigned long)lgfy_count, (unsigned long)lgfy_dropped);
+	/* resolve modules first so the table precedes the samples */
+	for (i = 0; i < lgfy_used; i += lgfy_buf[i] + 1)
+		for (k = 1; k <= lgfy_buf[i]; k++) lgfy_module_of(lgfy_buf[i + k]);
+	for (m = 0; m < lgfy_nmodules; m++)
+		fprintf(f, "m %d %s %s\n", m, lgfy_modules[m].main ? "main" : "lib", lgfy_modules[m].path);
+	for (i = 0; i < lgfy_used; i += lgfy_buf[i] + 1) {
+		fputs("s", f);
+		for (k = 1; k <= lgfy_buf[i]; k++) {
+			uintptr_t a = lgfy_buf[i + k];
+			m = lgfy_module_of(a);
+			if (m < 0) fprintf(f, " ?+%llx", (unsigned long long)a);
+			else fprintf(f, " %d+%llx", m, (unsigned long long)(a - lgfy_modules[m].base));
+		}
+		fputc('\n', f);
+	}
+	fclose(f);
+}
+
+__attribute__((constructor)) static void lgfy_init(void)
+{
+	lgfy_start();
+	atexit(lgfy_dump);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+// Sampling profiler for the "Sample" action. The program is linked with
+// lib/sampler-rt.c, which records call stacks about every millisecond and
+// writes them out at exit; here they are symbolized with addr2line and folded
+// into a flame graph tree plus per-line sample counts.
+const { execFile, spawn } = require("child_process");
+const fs = require("fs");
+const path = require("path");
+const install = require("./install");
+
+const tool = name => path.join(install.dir("toolchain"), "bin", name + ".exe");
+const RUNTIME = path.join(__dirname, "sampler-rt.c");
+
+// flags added to the normal (-O2) compile line: debug info and the runtime
+const SAMPLE_FLAGS = ["-g", "-fno-omit-frame-pointer", `"${RUNTIME}"`];
+
+// frames below main (CRT startup, kernel32/ntdll thunks) are dropped
+const ROOT_FUNCTION = "main";
+
+function run(exe, args) {
+  return new Promise((resolve, reject) => {
+    execFile(exe, args, { maxBuffer: 32 * 1024 * 1024, timeout: 30_000, windowsHide: true }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve(out);
+    });
+  });
+}
+
+// addr2line with the addresses on stdin (the list can exceed the command line limit)
+function addr2line(exe, addrs) {
+  return new Promise((resolve, reject) => {
+    const child = spawn(tool("addr2line"), ["-a", "-f", "-C", "-i", "-e", exe], { windowsHide: true });
+    let out = "", err = "";
+    child.stdout.on("data", d => (out += d));
+    child.stderr.on("data", d => (err += d));
+    child.on("error", reject);
+    child.on("close", code => (code ? reject(new Error(err.trim() || "addr2line failed")) : resolve(out)));
+    child.stdin.end(addrs.map(a => "0x" + a.toString(16)).join("\n") + "\n");
+  });
+}
+
+// samples.out -> { intervalUs, count, dropped, modules, stacks: [[{ mod, off }]] }
+function parseSamples(text) {
+  const res = { intervalUs: 1000, count: 0, dropped: 0, modules: {}, stacks: [] };
+  for (const line of text.split(/\r?\n/)) {
+    if (line.startsWith("# samples")) {
+      for (const [, k, v] of line.matchAll(/(\w+)=(\d+)/g)) {
+        if (k === "interval_us") res.intervalUs = +v;
+        else if (k in res) res[k] = +v;
+      }
+    } else if (line.startsWith("m ")) {
+      const m = /^m (\d+) (main|lib) (.*)$/.exec(line);
+      if (m) res.modules[m[1]] = { main: m[2] === "main", path: m[3] };
+    } else if (line.startsWith("s ")) {
+      res.stacks.push(line.slice(2).split(" ").map(f => {
+        const i = f.indexOf("+");
+        return { mod: f.slice(0, i), off: parseInt(f.slice(i + 1), 16) };
+      }));
+    }
+  }
+  return res;
+}
+
+// link-time address of the first byte of the image (PE ImageBase / first ELF LOAD vaddr)
+async function imageBase(exe) {
+  const out = await run(tool("objdump"), ["-p", exe]).catch(() => "");
+  const pe = /^ImageBase\s+([0-9a-fA-F]+)/m.exec(out);
+  if (pe) return parseInt(pe[1], 16);
+  const elf = /LOAD\s+off\s+0x[0-9a-f]+\s+vaddr\s+0x([0-9a-f]+)/.exec(out);
+  return elf ? parseInt(elf[1], 16) : 0;
+}
+
+// `addr2line -a -f -i` output -> Map(address -> [{ fn, file, line }] innermost first)
+function parseAddr2line(text) {
+  const map = new Map();
+  let frames = null;
+  const lines = text.split(/\r?\n/);
+  for (let i = 0; i < lines.length; i++) {
+    if (/^0x[0-9a-fA-F]+$/.test(lines[i])) {
+      frames = [];
+      map.set(parseInt(lines[i], 16), frames);
+    } else if (frames && lines[i]) {
+      const loc = /^(.*):(\d+|\?)(?: \(discriminator \d+\))?$/.exec(lines[i + 1] || "");
+      frames.push({ fn: lines[i], file: loc ? loc[1] : "??", line: loc && loc[2] !== "?" ? +loc[2] : null });
+      i++;
+    }
+  }
+  return map;
+}
+
+function child(node, name) {
+  let c = node.children.find(n => n.name === name);
+  if (!c) {
+    c = { name, value: 0, self: 0, lines: {}, children: [] };
+    node.children.push(c);
+  }
+  return c;
+}
+
+// Symbolize and fold the samples of `exe` (built from `source`).
+async function analyze(exe, samplesFile, source) {
+  const data = parseSamples(fs.readFileSync(samplesFile, "utf8"));
+  const mainMod = Object.keys(data.modules).find(id => data.modules[id].main);
+  const base = await imageBase(exe);
+
+  // return addresses point after the call: look up the call itself (off - 1)
+  const lookup = new Set();
+  for (const stack of data.stacks) {
+    stack.forEach((f, i) => { if (f.mod === mainMod) lookup.add(base + f.off - (i ? 1 : 0)); });
+  }
+  const symbols = lookup.size ? parseAddr2line(await addr2line(exe, [...lookup])) : new Map();
+  const sameFile = f => path.basename(f).toLowerCase() === path.basename(source).toLowerCase();
+
+  const root = { name: "all", value: 0, self: 0, lines: {}, children: [] };
+  const lineSelf = {}, lineTotal = {};
+  for (const stack of data.stacks) {
+    // root-first list of { name, line }; library frames collapse to the DLL name
+    const frames = [];
+    for (let i = stack.length - 1; i >= 0; i--) {
+      const f = stack[i];
+      if (f.mod !== mainMod) {
+        const mod = data.modules[f.mod];
+        const name = mod ? path.basename(mod.path) : "[unknown]";
+        if (!frames.length || frames[frames.length - 1].name !== name) frames.push({ name, line: null });
+        continue;
+      }
+      const sym = symbols.get(base + f.off - (i ? 1 : 0));
+      if (!sym || !sym.length) { frames.push({ name: `${path.basename(exe)}+0x${f.off.toString(16)}`, line: null }); continue; }
+      // addr2line lists inlined frames innermost first
+      for (let k = sym.length - 1; k >= 0; k--) {
+        const s = sym[k];
+        frames.push({ name: s.fn === "??" ? `${path.basename(exe)}+0x${f.off.toString(16)}` : s.fn, line: s.line && sameFile(s.file) ? s.line : null });
+      }
+    }
+    const start = frames.findIndex(f => f.name === ROOT_FUNCTION);
+    const chain = start > 0 ? frames.slice(start) : frames;
+    if (!chain.length) continue;
+
+    root.value++;
+    let node = root;
+    for (const f of chain) {
+      node = child(node, f.name);
+      node.value++;
+      if (f.line) node.lines[f.line] = (node.lines[f.line] || 0) + 1;
+    }
+    node.self++;
+
+    // per-line: self = deepest frame in the source file, total = anywhere on the stack
+    const inSource = chain.filter(f => f.line);
+    if (inSource.length) {
+      const leaf = inSource[inSource.length - 1].line;
+      lineSelf[leaf] = (lineSelf[leaf] || 0) + 1;
+    }
+    for (const l of new Set(inSource.map(f => f.line))) lineTotal[l] = (lineTotal[l] || 0) + 1;
+  }
+
+  const lines = Object.keys(lineTotal).map(l => ({ line: +l, self: lineSelf[l] || 0, total: lineTotal[l] }));
+  return {
+    tree: root,
+    lines,
+    samples: root.value,
+    dropped: data.dropped,
+    intervalMs: data.intervalUs / 1000
+  };
+}
+
+module.exports = { SAMPLE_FLAGS, parseSamples, parseAddr2line, analyze };
@@ -0,0 +1,142 @@
+// Append-only, gzip-compressed log of everything the terminal printed.
+//
+// Output is streamed into <dir>/<session>-NNN.log.gz segments as it arrives.
+// A segment is closed once it holds `segmentBytes` of uncompressed output;
+// only the newest `maxSegments` are kept. <session>.index.json lists the
+// segments and every run boundary (time, label, uncompressed offset), so a
+// teacher can jump to a given run. Each segment is a complete gzip member,
+// so segments can be concatenated as-is into one valid .gz file.
+const fs = require("fs");
+const path = require("path");
+const zlib = require("zlib");
+const { pipeline } = require("stream/promises");
+
+class SessionLog {
+  constructor(dir, opts = {}) {
+    this.dir = dir;
+    this.segmentBytes = opts.segmentBytes || 8 * 1024 * 1024;
+    this.maxSegments = opts.maxSegments || 64;
+    this.flushMs = opts.flushMs || 2000;
+    this.id = null;
+    this.indexWrite = Promise.resolve();
+    this.closing = Promise.resolve();
+  }
+
+  get active() {
+    return this.id !== null;
+  }
+
+  status() {
+    return { active: this.active, dir: this.dir, session: this.id, bytes: this.active ? this.bytes : 0 };
+  }
+
+  start() {
+    if (this.active) return;
+    fs.mkdirSync(this.dir, { recursive: true });
+    this.id = "session-" + new Date().toISOString().replace(/[:.]/g, "-");
+    this.index = { session: this.id, started: Date.now(), segments: [], runs: [] };
+    this.bytes = 0;
+    this.openSegment();
+  }
+
+  async stop() {
+    if (!this.active) return;
+    const closed = this.closeSegment();
+    this.index.ended = Date.now();
+    this.saveIndex();
+    this.id = null;
+    await closed;
+    await this.indexWrite;
+  }
+
+  openSegment() {
+    const file = `${this.id}-${String(this.index.segments.length).padStart(3, "0")}.log.gz`;
+    this.segment = { file, offset: this.bytes, bytes: 0 };
+    this.index.segments.push(this.segment);
+    this.gz = zlib.createGzip();
+    this.out = fs.createWriteStream(path.join(this.dir, file));
+    this.done = pipeline(this.gz, this.out).catch(err => console.error("session log:", err.message));
+    this.saveIndex();
+  }
+
+  // ends the current segment; resolves once it and every earlier one are on disk
+  closeSegment() {
+    clearTimeout(this.flushTimer);
+    this.flushTimer = null;
+    this.gz.end();
+    this.closing = Promise.all([this.closing, this.done]);
+    return this.closing;
+  }
+
+  write(data) {
+    if (!this.active) return;
+    const buf = Buffer.isBuffer(data) ? data : Buffer.from(String(data), "utf8");
+    this.gz.write(buf);
+    this.bytes += buf.length;
+    this.segment.bytes += buf.length;
+    if (this.segment.bytes >= this.segmentBytes) {
+      this.rotate();
+    } else if (!this.flushTimer) {
+      // sync-flush periodically so a crash loses at most `flushMs` of output
+      this.flushTimer = setTimeout(() => {
+        this.flushTimer = null;
+        if (this.active) this.gz.flush();
+      }, this.flushMs);
+    }
+  }
+
+  // record the start of a run at the current output offset
+  markRun(label) {
+    if (!this.active) return;
+    this.index.runs.push({
+      run: this.index.runs.length + 1,
+      label,
+      time: Date.now(),
+      segment: this.segment.file,
+      offset: this.bytes
+    });
+    this.gz.flush();
+    this.saveIndex();
+  }
+
+  rotate() {
+    const closed = this.closeSegment();
+    const live = this.index.segments.filter(s => !s.dropped);
+    for (const old of live.slice(0, Math.max(0, live.length + 1 - this.maxSegments))) {
+      old.dropped = true;
+      closed.then(() => fs.promises.unlink(path.join(this.dir, old.file))).catch(() => {});
+    }
+    this.openSegment();
+  }
+
+  // index writes are chained so they land in order
+  saveIndex() {
+    const file = path.join(this.dir, this.id + ".index.json");
+    const json = JSON.stringify(this.index, null, 2);
+    this.indexWrite = this.indexWrite.then(() => fs.promises.writeFile(file, json)).catch(() => {});
+  }
+
+  // Stream the whole session into `dest`: gzip as-is for *.gz, plain text otherwise.
+  // The open segment is closed first so everything written so far is included.
+  async exportTo(dest) {
+    if (!this.active) throw new Error("session log is off");
+    const segments = this.index.segments.filter(s => !s.dropped && s.bytes > 0);
+    // swap segments synchronously so output arriving meanwhile goes to the new one
+    const closed = this.closeSegment();
+    this.openSegment();
+    await closed;
+
+    const gzipped = dest.toLowerCase().endsWith(".gz");
+    const out = fs.createWriteStream(dest);
+    for (const seg of segments) {
+      const src = fs.createReadStream(path.join(this.dir, seg.file));
+      if (gzipped) await pipeline(src, out, { end: false });
+      else await pipeline(src, zlib.createGunzip(), out, { end: false });
+    }
+    out.end();
+    await new Promise((resolve, reject) => out.on("finish", resolve).on("error", reject));
+    return dest;
+  }
+}
+
+module.exports = SessionLog;
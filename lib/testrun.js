@@ -0,0 +1,131 @@
+// Test-case runner: each case is <name>.in (stdin) plus <name>.out (expected
+// stdout; .ans and .expected are accepted too) in one folder. Cases run in
+// parallel through lib/benchrun.c --run, which enforces the time and memory
+// limits; stdin/stdout are piped from here.
+const { spawn } = require("child_process");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+
+const EXPECTED_EXT = [".out", ".ans", ".expected"];
+const MAX_OUTPUT = 8 * 1024 * 1024;
+const DIFF_CONTEXT = 2;
+const DIFF_MAX_LINES = 2000; // larger outputs get a window around the first mismatch
+
+const natural = new Intl.Collator(undefined, { numeric: true }).compare;
+
+function loadCases(dir) {
+  const files = new Set(fs.readdirSync(dir));
+  const cases = [];
+  for (const f of files) {
+    if (!f.endsWith(".in")) continue;
+    const name = f.slice(0, -3);
+    const exp = EXPECTED_EXT.map(e => name + e).find(e => files.has(e));
+    cases.push({ name, input: path.join(dir, f), expected: exp ? path.join(dir, exp) : null });
+  }
+  return cases.sort((a, b) => natural(a.name, b.name));
+}
+
+// trailing spaces and trailing blank lines are not significant
+function lines(text) {
+  const list = text.replace(/\r\n?/g, "\n").split("\n").map(l => l.replace(/\s+$/, ""));
+  while (list.length && list[list.length - 1] === "") list.pop();
+  return list;
+}
+
+// line diff as [{ op: " " | "-" | "+", text, line }], trimmed to context around changes
+function diff(expected, actual) {
+  let ops = [];
+  if (expected.length <= DIFF_MAX_LINES && actual.length <= DIFF_MAX_LINES) {
+    // LCS table, then walk it forwards
+    const n = expected.length, m = actual.length;
+    const t = Array.from({ length: n + 1 }, () => new Uint16Array(m + 1));
+    for (let i = n - 1; i >= 0; i--)
+      for (let j = m - 1; j >= 0; j--)
+        t[i][j] = expected[i] === actual[j] ? t[i + 1][j + 1] + 1 : Math.max(t[i + 1][j], t[i][j + 1]);
+    let i = 0, j = 0;
+    while (i < n || j < m) {
+      if (i < n && j < m && expected[i] === actual[j]) { ops.push({ op: " ", text: expected[i], line: j + 1 }); i++; j++; }
+      else if (i < n && (j === m || t[i + 1][j] >= t[i][j + 1])) { ops.push({ op: "-", text: expected[i], line: i + 1 }); i++; }
+      else { ops.push({ op: "+", text: actual[j], line: j + 1 }); j++; }
+    }
+  } else {
+    let k = 0;
+    while (k < expected.length && k < actual.length && expected[k] === actual[k]) k++;
+    for (let x = Math.max(0, k - DIFF_CONTEXT); x < k; x++) ops.push({ op: " ", text: actual[x], line: x + 1 });
+    for (let x = k; x < Math.min(expected.length, k + 20); x++) ops.push({ op: "-", text: expected[x], line: x + 1 });
+    for (let x = k; x < Math.min(actual.length, k + 20); x++) ops.push({ op: "+", text: actual[x], line: x + 1 });
+    return ops;
+  }
+  const keep = ops.map((o, i) => o.op !== " " || ops.slice(Math.max(0, i - DIFF_CONTEXT), i + DIFF_CONTEXT + 1).some(p => p.op !== " "));
+  return ops.map((o, i) => (keep[i] ? o : i && keep[i - 1] ? { op: "…" } : null)).filter(Boolean);
+}
+
+function parseStats(file) {
+  try {
+    const line = fs.readFileSync(file, "utf8");
+    const r = {};
+    for (const [, k, v] of line.matchAll(/(\w+)=([^\s]*)/g)) r[k] = v;
+    return { wallMs: +r.wall_us / 1000, cpuMs: (+r.user_us + +r.sys_us) / 1000, rssKB: +r.rss_kb, exit: +r.exit, limit: r.limit || "" };
+  } catch (_) {
+    return null;
+  }
+}
+
+// Run one case. Result: { name, status, wallMs, cpuMs, rssKB, exit, diff, stderr }
+// status: pass | fail | ran (no expected output) | time | memory | output | crash | error
+// statsFile: where the runner leaves the case's stats; one per case running at a time
+function runCase(runner, argv, c, { timeMs, memMB, cwd, statsFile }) {
+  return new Promise(resolve => {
+    const child = spawn(runner, ["--run", statsFile, String(timeMs || 0), String(memMB || 0), ...argv], { cwd, windowsHide: true });
+    const out = [];
+    let outBytes = 0, err = "", overflow = false;
+    child.stdout.on("data", d => {
+      outBytes += d.length;
+      // closing the pipe ends the program with EPIPE (or the time limit)
+      if (outBytes > MAX_OUTPUT) { overflow = true; child.stdout.destroy(); return; }
+      out.push(d);
+    });
+    child.stderr.on("data", d => { if (err.length < 64 * 1024) err += d; });
+    child.stdin.on("error", () => {}); // program exited without reading all input
+    fs.createReadStream(c.input).on("error", () => child.stdin.end()).pipe(child.stdin);
+    child.on("error", e => resolve({ name: c.name, status: "error", stderr: e.message }));
+    child.on("close", () => {
+      const st = parseStats(statsFile) || { exit: null, limit: "" };
+      fs.rmSync(statsFile, { force: true });
+      const res = { name: c.name, ...st, stderr: err.slice(0, 4096) };
+      if (overflow) return resolve({ ...res, status: "output" });
+      if (st.limit === "time") return resolve({ ...res, status: "time" });
+      if (st.limit === "memory" || (memMB && st.exit && /MemoryError|bad_alloc|out of memory/i.test(err))) return resolve({ ...res, status: "memory" });
+      if (st.exit) return resolve({ ...res, status: "crash" });
+      if (!c.expected) return resolve({ ...res, status: "ran", output: Buffer.concat(out).toString().slice(0, 4096) });
+      const d = diff(lines(fs.readFileSync(c.expected, "utf8")), lines(Buffer.concat(out).toString()));
+      const failed = d.some(o => o.op === "-" || o.op === "+");
+      resolve({ ...res, status: failed ? "fail" : "pass", diff: failed ? d : undefined });
+    });
+  });
+}
+
+// Run all cases `jobs` at a time; onResult(result, index) is called as each one finishes.
+async function runAll(runner, argv, cases, opts, onResult) {
+  const jobs = Math.max(1, Math.min(opts.jobs || os.cpus().length, cases.length));
+  const statsDir = fs.mkdtempSync(path.join(os.tmpdir(), "languaggify-tests-"));
+  const results = new Array(cases.length);
+  let next = 0;
+  const worker = async () => {
+    while (next < cases.length) {
+      const i = next++;
+      // by index: case names that differ only in punctuation would share a file name
+      results[i] = await runCase(runner, argv, cases[i], { ...opts, statsFile: path.join(statsDir, `${i}.stats`) });
+      onResult(results[i], i);
+    }
+  };
+  try {
+    await Promise.all(Array.from({ length: jobs }, worker));
+  } finally {
+    fs.rmSync(statsDir, { recursive: true, force: true });
+  }
+  return results;
+}
+
+module.exports = { loadCases, lines, diff, parseStats, runCase, runAll };
@@ -0,0 +1,68 @@
+// Span recorder for the edit -> build -> run pipeline, exported in Chrome
+// trace-event format (load the JSON in chrome://tracing or ui.perfetto.dev).
+//
+// Timestamps are wall-clock microseconds (performance.timeOrigin + now()),
+// which the renderer computes the same way, so spans from both processes
+// line up on one timeline. Events go into a bounded ring; recording is cheap
+// enough to stay on all the time.
+const fs = require("fs");
+const { performance } = require("perf_hooks");
+
+const MAX_EVENTS = 50_000;
+const events = [];
+let dropped = 0;
+const processNames = new Map([[process.pid, "main"]]);
+
+function now() {
+  return Math.round((performance.timeOrigin + performance.now()) * 1000);
+}
+
+function push(ev) {
+  events.push(ev);
+  if (events.length > MAX_EVENTS) {
+    events.splice(0, MAX_EVENTS >> 3);
+    dropped += MAX_EVENTS >> 3;
+  }
+}
+
+// begin a span; call the returned function (optionally with extra args) to end it
+function span(name, args, cat = "main") {
+  const ts = now();
+  return (more) => {
+    push({ name, cat, ph: "X", ts, dur: now() - ts, pid: process.pid, tid: 0, args: more ? { ...args, ...more } : args });
+  };
+}
+
+// a completed span measured elsewhere (ts/dur in microseconds)
+function complete(name, ts, dur, args, cat = "main") {
+  push({ name, cat, ph: "X", ts, dur, pid: process.pid, tid: 0, args });
+}
+
+function instant(name, args, cat = "main") {
+  push({ name, cat, ph: "i", s: "p", ts: now(), pid: process.pid, tid: 0, args });
+}
+
+// events recorded by a renderer (see renderer/trace.js)
+function addRemote(pid, list, label = "renderer") {
+  processNames.set(pid, label);
+  for (const ev of list || []) {
+    if (!ev || typeof ev.name !== "string" || typeof ev.ts !== "number") continue;
+    push({ name: ev.name, cat: ev.cat || "renderer", ph: ev.ph === "i" ? "i" : "X", s: ev.ph === "i" ? "p" : undefined,
+      ts: ev.ts, dur: ev.dur || 0, pid, tid: 0, args: ev.args });
+  }
+}
+
+function toJSON() {
+  const meta = [...processNames].map(([pid, name]) => ({ name: "process_name", ph: "M", pid, tid: 0, args: { name } }));
+  return {
+    traceEvents: meta.concat(events),
+    displayTimeUnit: "ms",
+    otherData: { app: "languaggify", platform: process.platform, droppedEvents: dropped, exported: new Date().toISOString() }
+  };
+}
+
+function exportTo(dest) {
+  return fs.promises.writeFile(dest, JSON.stringify(toJSON()));
+}
+
+module.exports = { now, span, complete, instant, addRemote, toJSON, exportTo };
@@ -1,17 +1,103 @@
-const { app, BrowserWindow, ipcMain, dialog } = require("electron");
+const { app, BrowserWindow, ipcMain, dialog, shell } = require("electron");
 const { exec, execFile, spawn } = require("child_process");
 const fs = require("fs");
 const path = require("path");
+const { pathToFileURL } = require("url");
 const pty = require("node-pty");
 
 const languages = require("./languages");
+const install = require("./lib/install");
+const SessionLog = require("./lib/session-log");
+const trace = require("./lib/trace");
+const gprof = require("./lib/gprof");
+const gcov = require("./lib/gcov");
+const sampler = require("./lib/sampler");
+const bench = require("./lib/bench");
+const hostcpu = require("./lib/hostcpu");
+const { CompileCache, SharedCache, MB } = require("./lib/compile-cache");
+const { RemoteCompiler } = require("./lib/remote-compile");
+const { EditJournal } = require("./lib/edit-journal");
+const { PagedFile, LARGE_FILE_BYTES } = require("./lib/paged-file");
+const components = require("./lib/components");
+const { DEBUG_FLAGS, GdbSession, needsPrinters } = require("./lib/gdbmi");
+const testrun = require("./lib/testrun");
+const grade = require("./lib/grade");
 
-const tempDir = path.join(__dirname, "temp");
-if (!fs.existsSync(tempDir)) fs.mkdirSync(tempDir);
+// <app>/temp, or a per-user local directory in a shared install (lib/install.js)
+const tempDir = install.workDir;
+if (!fs.existsSync(tempDir)) fs.mkdirSync(tempDir, { recursive: true });
 
 let ptyProcess;
 let terminalBuffer = "";
 
+// opt-in full terminal log (toolbar toggle, or LANGUAGGIFY_SESSION_LOG=1 for lab images)
+const sessionLog = new SessionLog(path.join(tempDir, "sessions"));
+if (process.env.LANGUAGGIFY_SESSION_LOG === "1") sessionLog.start();
+let lastRunLabel = "terminal";
+
+// pty command written by a run -> echo -> first output line (see terminal-write)
+let runProbe = null;
+
+// exec() with a trace span around the child process
+function execTraced(name, cmd, opts, cb) {
+  const end = trace.span(name, { cmd });
+  return exec(cmd, opts, (e, out, err) => {
+    end({ ok: !e });
+    cb(e, out, err);
+  });
+}
+
+// promise form of execTraced; rejects with the compiler's stderr
+function execAsync(name, cmd, opts = {}) {
+  return new Promise((resolve, reject) => {
+    execTraced(name, cmd, { timeout: 60_000, ...opts }, (e, out, err) => {
+      if (e) return reject(new Error(String(err || e.message).trim()));
+      resolve({ out, err });
+    });
+  });
+}
+
+// program started outside the pty; terminal input is routed to its stdin
+let activeChild = null;
+
+// Spawn a program with stdout/stderr forwarded to the terminal. `exited`
+// resolves with the exit code after "[process exited N]" has been sent.
+function launchChild(sender, exePath, args = [], env = null) {
+  sessionLog.markRun(`run-exe ${path.basename(exePath)}`);
+  const endSpawn = trace.span("spawn exe", { exe: exePath });
+  const child = spawn(exePath, args, { cwd: tempDir, windowsHide: true, env: env ? { ...process.env, ...env } : process.env });
+  endSpawn();
+  activeChild = child;
+  const started = trace.now();
+  let firstByte = true;
+  const forward = d => {
+    if (firstByte) { firstByte = false; trace.complete("exe: first output", started, trace.now() - started); }
+    sessionLog.write(d);
+    try { sender.send('terminal-data', d.toString()); } catch(_){}
+  };
+  child.stdout.on('data', forward);
+  child.stderr.on('data', forward);
+  const exited = new Promise(resolve => {
+    child.on('error', err => { forward(`\n${err.message}\n`); });
+    child.on('close', code => {
+      if (activeChild === child) activeChild = null;
+      trace.complete("exe: run", started, trace.now() - started, { code });
+      forward(`\n[process exited ${code}]\n`);
+      resolve(code);
+    });
+  });
+  return { child, exited };
+}
+
+// worker scripts shipped in <vs>/assets (names are content-hashed), for MonacoEnvironment
+function monacoWorkers(vsDir) {
+  try {
+    return fs.readdirSync(path.join(vsDir, "assets")).filter(f => /\.worker-.*\.js$/.test(f)).join(",");
+  } catch (e) {
+    return "";
+  }
+}
+
 function createWindow() {
   const win = new BrowserWindow({
     width: 1300,
@@ -21,40 +107,168 @@ function createWindow() {
       contextIsolation: true
     }
   });
-  win.loadFile("index.html");
+  const query = {};
+  // trimmed editor bundle produced by `npm run build:monaco` (falls back to the full one)
+  let vsDir = path.join(install.dir("monaco-min"), "vs");
+  if (!fs.existsSync(path.join(vsDir, "languaggify-preload.js"))) vsDir = path.join(install.dir("monaco"), "vs");
+  if (vsDir !== path.join(__dirname, "monaco", "vs")) query.monaco = pathToFileURL(vsDir).href;
+  query.workers = monacoWorkers(vsDir);
+  win.loadFile(path.join(__dirname, "index.html"), { query });
+}
+
+// OpenMP builds: set (or clear) OMP_NUM_THREADS in front of the pty run command.
+// The pty shell keeps its environment, so "auto" has to remove an earlier value.
+function usesOpenMP(cfg, profile) {
+  return !!(cfg.profiles && cfg.profiles[profile] && cfg.profiles[profile].includes("-fopenmp"));
+}
+
+function ompCommand(cmd, cfg, opts) {
+  if (!cmd || !usesOpenMP(cfg, opts.profile)) return cmd;
+  const threads = parseInt(opts.threads, 10);
+  if (process.platform !== "win32") return threads > 0 ? `OMP_NUM_THREADS=${threads} ${cmd}` : `env -u OMP_NUM_THREADS ${cmd}`;
+  return (threads > 0 ? `$env:OMP_NUM_THREADS=${threads}; ` : "Remove-Item Env:OMP_NUM_THREADS -ErrorAction Ignore; ") + cmd;
+}
+
+// run-code options -> cfg.compile options. The host profile builds for the
+// detected ISA level (or opts.isa: x86-64-v2/v3/v4, native) and links
+// lib/isa-guard.c so the exe stops with a message on an older CPU.
+async function compileOptions(opts = {}) {
+  const copts = { profile: opts.profile };
+  if (opts.profile !== "host") return copts;
+  const cpu = await hostcpu.detect(tempDir);
+  const chosen = opts.isa && opts.isa !== "auto" ? opts.isa : cpu.level;
+  // below x86-64-v2 a level would be older than the toolchain's core2 default
+  const march = hostcpu.LEVELS.includes(chosen) ? chosen : cpu.march;
+  const guard = hostcpu.LEVELS.includes(chosen) ? chosen : hostcpu.LEVELS.includes(cpu.level) ? cpu.level : null;
+  copts.march = march;
+  copts.isa = march === "native" ? cpu.march : march;
+  copts.flags = guard ? [`"${await hostcpu.guardObject(tempDir, guard)}"`] : [];
+  return copts;
+}
+
+// Compiled programs keyed by source, compile command, toolchain and ISA level,
+// optionally backed by a lab-wide tier: "compileCache" in shared-install.json
+// ({ shared: dir or http://server:port, maxMB, localMaxMB }) or
+// LANGUAGGIFY_COMPILE_CACHE=<dir or url>. Seats only read it; the teacher
+// machine or build server that fills it is given
+// LANGUAGGIFY_COMPILE_CACHE_TOKEN (the server's upload token) or, for a
+// directory, LANGUAGGIFY_COMPILE_CACHE_WRITE=1 in its own environment.
+const cacheConfig = install.config.compileCache || {};
+const compileCache = new CompileCache(path.join(tempDir, "compile-cache"), { maxBytes: (cacheConfig.localMaxMB || 256) * MB });
+const sharedCacheLocation = process.env.LANGUAGGIFY_COMPILE_CACHE || cacheConfig.shared;
+fs.mkdirSync(compileCache.dir, { recursive: true });
+const sharedCache = SharedCache.open(sharedCacheLocation, {
+  maxBytes: (cacheConfig.maxMB || 4096) * MB,
+  token: process.env.LANGUAGGIFY_COMPILE_CACHE_TOKEN || null,
+  writable: process.env.LANGUAGGIFY_COMPILE_CACHE_WRITE === "1",
+  statsFile: path.join(compileCache.dir, "shared-stats.json")
+});
+
+// Offloads the compile proper to lab build servers (lib/remote-compile.js):
+// "remoteCompile": { servers: [url, ...], timeoutMs } in shared-install.json
+// or LANGUAGGIFY_REMOTE_COMPILE=<url>[,<url>...].
+const remoteConfig = install.config.remoteCompile || {};
+const remoteCompiler = RemoteCompiler.open(process.env.LANGUAGGIFY_REMOTE_COMPILE || remoteConfig.servers, { timeoutMs: remoteConfig.timeoutMs });
+
+// preprocessed source of `file` (with line markers, so diagnostics of a remote
+// compile name the seat's files); null when preprocessing fails, the compile
+// itself then reports the error
+async function preprocess(cfg, file, copts) {
+  try {
+    const pre = cfg.compile(file, { ...copts, flags: [...(copts.flags || []), "-E"], out: "-" });
+    return (await execAsync("preprocess", pre, { maxBuffer: 64 * 1024 * 1024 })).out;
+  } catch (_) {
+    return null;
+  }
+}
+
+// Lab-wide key: the preprocessed source without line markers (they carry
+// paths) and the compile command with per-user paths replaced.
+async function sharedKey(cfg, file, copts, cmd, source) {
+  const flags = cmd.split(install.dir("toolchain")).join("<toolchain>").split(cfg.argv(file)[0]).join("<out>")
+    .split(file).join("<src>").split(tempDir).join("<tmp>");
+  return sharedCache.key({
+    source: source.replace(/^# \d+ ".*$/gm, ""), flags, toolchain: await hostcpu.toolchainDigest(), isa: copts.isa || "baseline"
+  });
+}
+
+// compile on a build server and link here; null when no server took the job
+// in time (compile locally), rejects with the diagnostics on a compile error
+async function remoteBuild(cfg, file, copts, source) {
+  // this CPU's -march could not be named: only a local -march=native fits it
+  if (copts.isa === "native") return null;
+  const lang = path.extname(file) === ".c" ? "c" : "c++";
+  const res = await remoteCompiler.compile({ lang, flags: cfg.compileFlags(copts), source, toolchain: await hostcpu.toolchainDigest() });
+  if (!res) return null;
+  const obj = file.replace(/\.\w+$/, ".remote.o");
+  fs.writeFileSync(obj, res.object);
+  const { out, err } = await execAsync("link", cfg.link([obj], copts));
+  trace.instant("remote compile", { server: res.server, ms: res.ms });
+  return [res.warnings, out, err].filter(Boolean).join("\n") || `✓ Compiled (remote: ${new URL(res.server).host})`;
+}
+
+// compile `file` to the language's default exe, reusing a cached build; rejects with the compiler output
+async function buildExe(cfg, file, code, opts) {
+  const copts = await compileOptions(opts);
+  const cmd = cfg.compile(file, copts);
+  const exe = cfg.argv(file)[0];
+  await components.ensureFor(code, cmd);
+  const key = compileCache.key({ code, command: cmd, toolchain: hostcpu.toolchainId(), isa: copts.isa || "baseline" });
+  if (compileCache.get(key, exe)) {
+    trace.instant("compile cache hit", { key });
+    return "✓ Compiled (cached)";
+  }
+  const source = (sharedCache || remoteCompiler) && await preprocess(cfg, file, copts);
+  const shared = sharedCache && source && await sharedKey(cfg, file, copts, cmd, source);
+  if (shared && await sharedCache.get(shared, exe)) {
+    trace.instant("lab compile cache hit", { key: shared });
+    compileCache.put(key, exe);
+    return "✓ Compiled (lab cache)";
+  }
+  const started = Date.now();
+  let result = remoteCompiler && source ? await remoteBuild(cfg, file, copts, source) : null;
+  if (result === null) {
+    const { out, err } = await execAsync("compile", cmd);
+    result = out || err || "✓ Compiled";
+  }
+  compileCache.put(key, exe);
+  // uploaded from the local entry (the exe may be rebuilt meanwhile), without delaying the run
+  if (shared) sharedCache.put(shared, compileCache.file(key), { ms: Date.now() - started });
+  return result;
 }
 
-ipcMain.handle("run-code", async (_, { lang, code, opts }) => {
+// uncached build to copts.out (benchmark, profiler, debug builds ...), with the
+// components the code needs (lib/components.js) in place first
+async function compileTo(label, cfg, file, code, copts) {
+  const cmd = cfg.compile(file, copts);
+  await components.ensureFor(code, cmd);
+  return execAsync(label, cmd);
+}
+
+// run-code and run-exe are plain functions so bench/run-latency.js can drive them headless
+async function runCode({ lang, code, opts }) {
   const cfg = languages[lang];
   if (!cfg) return "❌ Language not supported";
 
   const file = path.join(tempDir, cfg.filename);
+  const endWrite = trace.span("write source", { lang, bytes: code.length });
   fs.writeFileSync(file, code);
+  endWrite();
+  lastRunLabel = opts && opts.action ? `${lang} ${opts.action}` : lang;
 
   // If renderer requested to run inside integrated terminal, return commands instead of executing
   if (opts && opts.runInTerminal) {
     // C: provide compile/run commands
     if (lang === 'c' || lang === 'cpp') {
-      const compileCmd = cfg.compile ? cfg.compile(file) : null;
-      const runCmd = cfg.runCommand ? cfg.runCommand(file) : null;
-      if (opts.action === 'compile') {
+      const runCmd = ompCommand(cfg.runCommand ? cfg.runCommand(file) : null, cfg, opts);
+      if (opts.action === 'compile' || opts.action === 'compile-run') {
         // perform compile and return compiled info
-        if (!compileCmd) return "Error: compile command not available";
-        return new Promise(resolve => {
-          exec(compileCmd, { timeout: 60_000 }, (e, out, err) => {
-            if (e) return resolve(err?.message || err || "Error");
-            resolve({ compiled: true, exe: runCmd, out: out || err || '✓ Compiled' });
-          });
-        });
-      }
-      if (opts.action === 'compile-run') {
-        if (!compileCmd || !runCmd) return "Error: compile/run commands not available";
-        return new Promise(resolve => {
-          exec(compileCmd, { timeout: 60_000 }, (e, out, err) => {
-            if (e) return resolve(err?.message || err || "Error");
-            resolve({ compiled: true, exe: runCmd, out: out || err || '✓ Compiled' });
-          });
-        });
+        if (!cfg.compile || !runCmd) return "Error: compile/run commands not available";
+        try {
+          return { compiled: true, exe: runCmd, out: await buildExe(cfg, file, code, opts) };
+        } catch (err) {
+          return err.message || "Error";
+        }
       }
       if (opts.action === 'run') {
         // just return run command; assume exe exists
@@ -70,34 +284,38 @@ ipcMain.handle("run-code", async (_, { lang, code, opts }) => {
   // Default behavior: execute and return output (legacy behavior)
   // For C/C++ compile-only flow
   if (lang === 'c' || lang === 'cpp') {
-    const compileCmd = cfg.compile ? cfg.compile(file) : (cfg.run ? cfg.run(file) : null);
-    return new Promise(resolve => {
-      if (!compileCmd) return resolve('Error: no compile command');
-      exec(compileCmd, { timeout: 60_000 }, (e, out, err) => {
-        if (e) return resolve(err?.message || err || "Error");
-        const exePath = path.join(tempDir, 'main.exe');
-        resolve({ compiled: true, exe: exePath, out: out || err || '✓ Compiled' });
-      });
-    });
+    if (!cfg.compile) return 'Error: no compile command';
+    try {
+      return { compiled: true, exe: cfg.argv(file)[0], out: await buildExe(cfg, file, code, opts || {}) };
+    } catch (err) {
+      return err.message || "Error";
+    }
   }
 
   return new Promise(resolve => {
-    exec(cfg.run(file), { timeout: 10000 }, (e, out, err) => {
+    // cfg.run() returns a PowerShell command line
+    const shell = process.platform === "win32" ? "powershell.exe" : undefined;
+    execTraced("run", cfg.run(file), { timeout: 10000, shell }, (e, out, err) => {
       if (e) return resolve(err?.message || err || "Error");
       resolve(out || err || "✓ Done");
     });
   });
-});
+}
+
+ipcMain.handle("run-code", (_, args) => runCode(args));
 
-ipcMain.handle('run-exe', async (e, exePath) => {
+// `sender` receives 'terminal-data' messages (a webContents, or a stub in benchmarks)
+async function runExe(sender, exePath, args = []) {
   try {
     if (!exePath) return 'no exe';
+    trace.instant("run-exe", { exe: exePath, pty: !!ptyProcess });
 
     // If an integrated pty terminal is running, write the invocation there
     if (ptyProcess) {
       try {
         // Use PowerShell call operator to execute a quoted path safely
-        ptyProcess.write(`& "${exePath}"\r`);
+        runProbe = { ts: trace.now(), echoed: false };
+        ptyProcess.write(`& ${[exePath, ...args].map(a => `"${a}"`).join(" ")}\r`);
         return 'started';
       } catch (err) {
         // fallthrough to spawn if writing fails
@@ -105,30 +323,39 @@ ipcMain.handle('run-exe', async (e, exePath) => {
     }
 
     // No pty available: spawn the exe and forward stdout/stderr back to renderer
-    const child = spawn(exePath, [], { cwd: tempDir, windowsHide: true });
-    child.stdout.on('data', d => { try { e.sender.send('terminal-data', d.toString()); } catch(_){} });
-    child.stderr.on('data', d => { try { e.sender.send('terminal-data', d.toString()); } catch(_){} });
-    child.on('exit', code => { try { e.sender.send('terminal-data', `\n[process exited ${code}]\n`); } catch(_){} });
+    launchChild(sender, exePath, args);
     return 'started';
   } catch (err) {
     return 'Error: ' + err.message;
   }
-});
+}
+
+ipcMain.handle('run-exe', (e, exePath) => runExe(e.sender, exePath));
 
 /* TERMINAL */
 ipcMain.handle("terminal-start", (e) => {
+  const endStart = trace.span("terminal-start");
   if (ptyProcess) {
     try { ptyProcess.kill(); } catch (er) {}
     ptyProcess = null;
   }
   terminalBuffer = "";
+  // the renderer restarts the terminal for every run, so this is the run boundary
+  sessionLog.markRun(lastRunLabel);
+  lastRunLabel = "terminal";
   ptyProcess = pty.spawn(
     process.platform === "win32" ? "powershell.exe" : "bash",
     [],
     { cwd: tempDir }
   );
+  const shellStarted = trace.now();
+  let shellReady = false;
+  runProbe = null;
 
   ptyProcess.on("data", d => {
+    if (!shellReady) { shellReady = true; trace.complete("pty: shell start", shellStarted, trace.now() - shellStarted); }
+    if (runProbe) probeRunOutput(d);
+    sessionLog.write(d);
     terminalBuffer += d;
     // keep buffer bounded to avoid memory issues
     if (terminalBuffer.length > 200_000) terminalBuffer = terminalBuffer.slice(-100_000);
@@ -139,10 +366,33 @@ ipcMain.handle("terminal-start", (e) => {
     try { e.sender.send("terminal-data", "\n[process exited]\n"); } catch (er) {}
   });
 
+  endStart();
   return "started";
 });
 
-ipcMain.on("terminal-write", (_, data) => {
+// The shell first echoes the command line; the first chunk after that line
+// ends is the program's first output (PowerShell parse + process launch).
+function probeRunOutput(d) {
+  const t = trace.now();
+  if (!runProbe.echoed) {
+    trace.complete("pty: command echo", runProbe.ts, t - runProbe.ts);
+    runProbe.echoed = true;
+    const nl = d.indexOf("\n");
+    if (nl < 0 || nl === d.length - 1) return;
+  }
+  trace.complete("pty: command -> first output", runProbe.ts, t - runProbe.ts);
+  runProbe = null;
+}
+
+ipcMain.on("terminal-write", (e, data) => {
+  // a program spawned outside the pty has no tty: echo and translate CR ourselves
+  if (activeChild && activeChild.stdin.writable) {
+    const text = String(data).replace(/\r/g, "\n");
+    try { activeChild.stdin.write(text); e.sender.send("terminal-data", text); } catch (er) {}
+    return;
+  }
+  // a command line sent by the Run button (ends with CR) starts the probe
+  if (typeof data === "string" && data.length > 1 && data.endsWith("\r")) runProbe = { ts: trace.now(), echoed: false };
   try { ptyProcess?.write(data); } catch (er) {}
 });
 
@@ -154,6 +404,338 @@ ipcMain.handle("terminal-stop", () => {
   return "stopped";
 });
 
+/* PROFILING */
+// Build with -pg, run (output goes to the terminal), then analyse gmon.out with gprof.
+ipcMain.handle("profile-run", async (e, { lang, code }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg || !cfg.compile) return "Error: profiling is available for C and C++";
+    const file = path.join(tempDir, cfg.filename);
+    fs.writeFileSync(file, code);
+    const exe = path.join(tempDir, "main-pg.exe");
+    await components.ensure("tools");
+    await compileTo("compile (gprof)", cfg, file, code, { flags: gprof.PROFILE_FLAGS, out: exe });
+
+    const gmon = path.join(tempDir, "gmon.out");
+    fs.rmSync(gmon, { force: true });
+    const exitCode = await launchChild(e.sender, exe).exited;
+    if (!fs.existsSync(gmon)) return "Error: no gmon.out written (the program must return from main or call exit)";
+    const endAnalyze = trace.span("gprof");
+    const result = await gprof.analyze(exe, tempDir, file);
+    endAnalyze();
+    return { exitCode, ...result };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+/* SAMPLING PROFILER */
+// Build with the sampling runtime linked in, run, then fold the stacks it wrote.
+ipcMain.handle("sample-run", async (e, { lang, code }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg || !cfg.compile) return "Error: sampling is available for C and C++";
+    const file = path.join(tempDir, cfg.filename);
+    fs.writeFileSync(file, code);
+    const exe = path.join(tempDir, "main-sample.exe");
+    await components.ensure("tools");
+    await compileTo("compile (sampler)", cfg, file, code, { flags: sampler.SAMPLE_FLAGS, out: exe });
+
+    const samples = path.join(tempDir, "samples.out");
+    fs.rmSync(samples, { force: true });
+    const exitCode = await launchChild(e.sender, exe, [], { LANGUAGGIFY_SAMPLES: samples }).exited;
+    if (!fs.existsSync(samples)) return "Error: no samples written (the program must return from main or call exit)";
+    const endAnalyze = trace.span("symbolize samples");
+    const result = await sampler.analyze(exe, samples, file);
+    endAnalyze();
+    return { exitCode, ...result };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+/* BENCHMARK */
+// Repeated runs with statistics; history is kept per file key (path or "untitled.<lang>").
+const benchHistory = new bench.History(path.join(tempDir, "bench-history.json"));
+ipcMain.handle("benchmark-run", async (_, { lang, code, key, warmup, runs }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg) return "Error: unknown language " + lang;
+    const file = path.join(tempDir, cfg.filename);
+    fs.writeFileSync(file, code);
+    let argv = cfg.argv(file);
+    if (cfg.compile) {
+      const exe = path.join(tempDir, "main-bench.exe");
+      await compileTo("compile (benchmark)", cfg, file, code, { out: exe });
+      argv = [exe];
+    }
+    const endBench = trace.span("benchmark", { lang, warmup, runs });
+    const result = await bench.measure(tempDir, argv, { warmup, runs });
+    endBench();
+    return { ...result, history: benchHistory.add(key, code, result) };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+ipcMain.handle("benchmark-history", (_, { key, clear }) => {
+  if (clear) benchHistory.clear(key);
+  return benchHistory.list(key);
+});
+
+/* COMPILE CACHE */
+// hit rates of this seat's cache and, when configured, of the lab-wide tier per seat,
+// and the state of the build servers
+ipcMain.handle("cache-stats", async () => ({
+  local: compileCache.stats(),
+  shared: sharedCache ? { location: sharedCacheLocation, ...await sharedCache.stats() } : null,
+  remote: remoteCompiler ? remoteCompiler.status() : null
+}));
+
+/* HOST CPU */
+ipcMain.handle("host-cpu", async () => {
+  try {
+    return await hostcpu.detect(tempDir);
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+/* OPENMP SCALING */
+// Build with an OpenMP profile (openmp, or parallel for C++) and time the
+// program at 1, 2, 4, ... threads.
+ipcMain.handle("scaling-run", async (_, { lang, code, profile = "openmp", maxThreads, runs }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg || !usesOpenMP(cfg, profile)) return `Error: no OpenMP build profile "${profile}" for ${lang}`;
+    const file = path.join(tempDir, cfg.filename);
+    fs.writeFileSync(file, code);
+    const exe = path.join(tempDir, "main-omp.exe");
+    await compileTo(`compile (${profile})`, cfg, file, code, { profile, out: exe });
+    const endScaling = trace.span("scaling", { lang, profile, maxThreads, runs });
+    const points = await bench.scaling(tempDir, [exe], { maxThreads: maxThreads || undefined, runs });
+    endScaling();
+    return { points };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+/* TEST CASES */
+// Build through run-code, then run every <name>.in in `dir` in parallel; each
+// result is pushed as a "test-event" as soon as it finishes.
+ipcMain.handle("pick-folder", async (e, { title }) => {
+  const win = BrowserWindow.fromWebContents(e.sender);
+  const res = await dialog.showOpenDialog(win, { properties: ["openDirectory"], title });
+  return res.canceled || !res.filePaths.length ? "cancelled" : res.filePaths[0];
+});
+
+ipcMain.handle("tests-run", async (e, { lang, code, dir, timeMs = 2000, memMB = 256 }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg) return "Error: unknown language " + lang;
+    const cases = testrun.loadCases(dir);
+    if (!cases.length) return `Error: no .in files in ${dir}`;
+    const built = await runCode({ lang, code, opts: { runInTerminal: true, action: "compile" } });
+    if (cfg.compile && !(built && built.compiled)) return "Error: " + String(built).trim();
+    const argv = cfg.argv(path.join(tempDir, cfg.filename));
+    const runner = await bench.runner(tempDir);
+
+    const started = trace.now();
+    e.sender.send("test-event", { type: "start", cases: cases.map(c => c.name) });
+    const results = await testrun.runAll(runner, argv, cases, { timeMs, memMB, cwd: tempDir }, (result, index) => {
+      try { e.sender.send("test-event", { type: "result", index, result }); } catch (_) {}
+    });
+    const wallMs = (trace.now() - started) / 1000;
+    trace.complete("tests", started, trace.now() - started, { cases: cases.length });
+    return { total: results.length, passed: results.filter(r => r.status === "pass").length, wallMs };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+/* GRADING */
+// Grade a folder of submissions against a folder of test cases; the CSV and
+// HTML reports are written next to the submissions.
+ipcMain.handle("grade-run", async (e, { dir, casesDir, timeMs = 2000, memMB = 256 }) => {
+  try {
+    const started = trace.now();
+    const runner = await bench.runner(tempDir);
+    const report = await grade.gradeFolder({ dir, casesDir, runner, workRoot: path.join(tempDir, "grading"), timeMs, memMB }, p => {
+      try { e.sender.send("grade-event", p); } catch (_) {}
+    });
+    const csv = path.join(dir, "grading-report.csv");
+    const html = path.join(dir, "grading-report.html");
+    fs.writeFileSync(csv, grade.toCSV(report));
+    fs.writeFileSync(html, grade.toHTML(report, `Grading: ${path.basename(dir)}`));
+    trace.complete("grading", started, trace.now() - started, { submissions: report.results.length });
+    return {
+      csv, html,
+      files: report.results.reduce((n, r) => n + r.files.length, 0),
+      unique: report.results.length,
+      wallMs: (trace.now() - started) / 1000
+    };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+ipcMain.handle("open-path", (_, { file }) => shell.openPath(file));
+
+/* DEBUGGER */
+// One gdb/MI session at a time; stops are pushed to the renderer as "debug-event".
+let debugSession = null;
+
+function debugSend(sender, ev) {
+  try { sender.send("debug-event", ev); } catch (_) {}
+}
+
+async function debugBreak(session, line, on) {
+  if (on && !session.breakpoints.has(line)) {
+    const r = await session.command(`-break-insert -f "${session.source}:${line}"`);
+    session.breakpoints.set(line, r.bkpt.number);
+  } else if (!on && session.breakpoints.has(line)) {
+    await session.command(`-break-delete ${session.breakpoints.get(line)}`);
+    session.breakpoints.delete(line);
+  }
+}
+
+async function onDebugStopped(sender, session, data) {
+  if (/^exited/.test(data.reason || "")) {
+    debugSend(sender, { state: "exited", code: data["exit-code"] != null ? parseInt(data["exit-code"], 8) : 0 });
+    return session.stop();
+  }
+  // varobjs hold values from the previous stop
+  for (const name of session.varobjs) await session.command(`-var-delete ${name}`).catch(() => {});
+  session.varobjs = [];
+  const ev = { state: "stopped", reason: data.reason || "", line: data.frame ? +data.frame.line || null : null, func: data.frame && data.frame.func };
+  if (session.firstStop) {
+    ev.firstStopMs = Math.round((trace.now() - session.firstStop) / 1000);
+    trace.complete("debug: first stop", session.firstStop, trace.now() - session.firstStop);
+    session.firstStop = null;
+  }
+  try {
+    const stack = await session.command("-stack-list-frames 0 63");
+    ev.frames = stack.stack.map(f => ({ level: +f.level, func: f.func, file: f.file, line: f.line ? +f.line : null }));
+    const vars = await session.command("-stack-list-variables --simple-values");
+    ev.locals = vars.variables.map(v => ({ name: v.name, type: v.type, value: v.value, arg: v.arg === "1" }));
+  } catch (err) {
+    ev.error = err.message;
+  }
+  debugSend(sender, ev);
+}
+
+ipcMain.handle("debug-start", async (e, { lang, code, breakpoints = [] }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg || !cfg.compile) return "Error: debugging is available for C and C++";
+    if (debugSession) {
+      const old = debugSession;
+      debugSession = null;
+      await old.stop();
+    }
+    const started = trace.now();
+    const file = path.join(tempDir, cfg.filename);
+    fs.writeFileSync(file, code);
+    const exe = path.join(tempDir, "main-dbg.exe");
+    await components.ensure("gdb");
+    await compileTo("compile (debug)", cfg, file, code, { flags: DEBUG_FLAGS, out: exe });
+
+    const session = new GdbSession({ cwd: tempDir, indexCache: path.join(tempDir, "gdb-index") });
+    Object.assign(session, { source: cfg.filename, breakpoints: new Map(), varobjs: [], firstStop: started });
+    debugSession = session;
+    session.on("output", d => { sessionLog.write(d); try { e.sender.send("terminal-data", d); } catch (_) {} });
+    session.on("running", () => debugSend(e.sender, { state: "running" }));
+    session.on("stopped", data => onDebugStopped(e.sender, session, data));
+    // a replaced session ending must not reset the new one's panel
+    session.on("exit", () => {
+      if (debugSession !== session) return;
+      debugSession = null;
+      debugSend(e.sender, { state: "ended" });
+    });
+
+    const endStart = trace.span("gdb start");
+    await session.start(exe);
+    for (const line of breakpoints) await debugBreak(session, line, true);
+    endStart();
+    await session.command("-exec-run");
+    return "started";
+  } catch (err) {
+    if (debugSession) debugSession.stop();
+    return "Error: " + (/ENOENT/.test(err.message) ? "gdb.exe not found in c c++/bin" : err.message);
+  }
+});
+
+const DEBUG_COMMANDS = { continue: "-exec-continue", next: "-exec-next", step: "-exec-step", finish: "-exec-finish" };
+ipcMain.handle("debug-cmd", async (_, { cmd }) => {
+  if (!debugSession) return "Error: not debugging";
+  try {
+    if (cmd === "stop") {
+      await debugSession.stop();
+      return "stopped";
+    }
+    if (!DEBUG_COMMANDS[cmd]) return "Error: unknown debug command " + cmd;
+    await debugSession.command(DEBUG_COMMANDS[cmd]);
+    return "ok";
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+ipcMain.handle("debug-break", async (_, { line, on }) => {
+  if (!debugSession) return "ok"; // applied at the next debug-start
+  try {
+    await debugBreak(debugSession, line, on);
+    return "ok";
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+// children of a local (`expr`) or of an expanded varobj (`name`)
+ipcMain.handle("debug-var", async (_, { expr, type, name }) => {
+  if (!debugSession) return "Error: not debugging";
+  try {
+    if (!name) {
+      if (needsPrinters(type)) await debugSession.ensurePrinters();
+      const v = await debugSession.command(`-var-create - * ${JSON.stringify(expr)}`);
+      debugSession.varobjs.push(v.name);
+      name = v.name;
+    }
+    const r = await debugSession.command(`-var-list-children --all-values ${name}`);
+    return (r.children || []).map(c => ({ name: c.name, exp: c.exp, type: c.type, value: c.value, more: +c.numchild > 0 || c.dynamic === "1" }));
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+/* COVERAGE */
+// Build with --coverage (reused while the source is unchanged), run, then read
+// per-line counts with gcov. Counts accumulate over runs until `reset`.
+const coverage = new gcov.Coverage(tempDir);
+ipcMain.handle("coverage-run", async (e, { lang, code, reset }) => {
+  try {
+    const cfg = languages[lang];
+    if (!cfg || !cfg.compile) return "Error: coverage is available for C and C++";
+    const file = path.join(tempDir, cfg.filename);
+    await components.ensure("tools");
+    if (coverage.prepare(code)) {
+      fs.writeFileSync(file, code);
+      await compileTo("compile (coverage)", cfg, file, code, { flags: gcov.COVERAGE_FLAGS, out: coverage.exe });
+    } else if (reset) {
+      coverage.reset();
+    }
+    const exitCode = await launchChild(e.sender, coverage.exe).exited;
+    const endCollect = trace.span("gcov");
+    const result = await coverage.collect(file);
+    endCollect();
+    return { exitCode, ...result };
+  } catch (err) {
+    coverage.hash = null; // a failed build must not be reused
+    return "Error: " + err.message;
+  }
+});
+
 /* FILE SAVE / OPEN */
 ipcMain.handle("save-file", async (e, { name, content }) => {
   try {
@@ -182,12 +764,64 @@ ipcMain.handle("open-file", async (e, file) => {
       if (res.canceled || !res.filePaths.length) return "cancelled";
       target = res.filePaths[0];
     }
+    // large files go to the paged viewer instead of the editor
+    const size = fs.statSync(target).size;
+    if (size > LARGE_FILE_BYTES) return { path: target, size, large: true };
     return { path: target, content: fs.readFileSync(target, "utf8") };
   } catch (e) {
     return "Error: " + e.message;
   }
 });
 
+/* PAGED VIEWER */
+// files too large for the editor (lib/paged-file.js), by id
+const pagedFiles = new Map();
+let pagedSeq = 0;
+
+function pagedCall(fn) {
+  return async (_, { id, ...args }) => {
+    try {
+      const pf = pagedFiles.get(id);
+      if (!pf) return "Error: file is not open";
+      return await fn(pf, args);
+    } catch (err) {
+      return "Error: " + err.message;
+    }
+  };
+}
+
+ipcMain.handle("paged-open", (_, { file }) => {
+  try {
+    const id = ++pagedSeq;
+    pagedFiles.set(id, new PagedFile(file));
+    return { id, ...pagedFiles.get(id).info() };
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+ipcMain.handle("paged-read", pagedCall((pf, { start, count }) => pf.read(start, count)));
+ipcMain.handle("paged-find", pagedCall((pf, { text, from }) => pf.find(text, from)));
+ipcMain.handle("paged-text", pagedCall(async (pf, { start, end }) => ({ text: await pf.text(start, end) })));
+ipcMain.handle("paged-replace", pagedCall((pf, { start, end, text }) => pf.replaceLines(start, end, text)));
+ipcMain.handle("paged-close", (_, { id }) => {
+  if (pagedFiles.has(id)) pagedFiles.get(id).close();
+  pagedFiles.delete(id);
+});
+
+/* EDIT JOURNAL */
+// autosave: the renderer streams edit deltas, lib/edit-journal.js keeps them
+// crash-safe and compacts them into the file
+const journal = new EditJournal(path.join(tempDir, "journal"));
+let journalClosed = false;
+
+ipcMain.handle("journal-recover", () => journal.recover().catch(err => "Error: " + err.message));
+ipcMain.handle("journal-begin", (_, doc) => journal.begin(doc).catch(err => "Error: " + err.message));
+ipcMain.on("journal-append", (_, { seq, changes }) => journal.append(seq, changes));
+// null: the journal had stopped (a lost batch); the renderer starts it over
+ipcMain.handle("journal-save", () => journal.compact()
+  .then(file => file || "Error: autosave had stopped; the file was not saved")
+  .catch(err => "Error: " + err.message));
+
 ipcMain.handle("terminal-save", async (e, { name }) => {
   try {
     let dest = name;
@@ -199,6 +833,8 @@ ipcMain.handle("terminal-save", async (e, { name }) => {
       if (res.canceled) return "cancelled";
       dest = res.filePath;
     }
+    // with the session log on, save the whole session (streamed, not just the tail)
+    if (sessionLog.active) return await sessionLog.exportTo(dest);
     fs.writeFileSync(dest, terminalBuffer);
     return dest;
   } catch (e) {
@@ -218,16 +854,60 @@ ipcMain.handle("save-file-silent", (e, { name, content }) => {
   }
 });
 
-ipcMain.handle("terminal-save-silent", (e, { name }) => {
+ipcMain.handle("terminal-save-silent", async (e, { name }) => {
   try {
     const safeName = path.basename(name || "terminal.txt");
     const dest = path.join(tempDir, safeName);
-    fs.writeFileSync(dest, terminalBuffer);
+    if (sessionLog.active) await sessionLog.exportTo(dest);
+    else fs.writeFileSync(dest, terminalBuffer);
     return "Saved";
   } catch (err) {
     return "Error: " + err.message;
   }
 });
 
+ipcMain.on("trace-events", (e, list) => {
+  try { trace.addRemote(e.sender.getOSProcessId(), list); } catch (er) {}
+});
+
+ipcMain.handle("trace-export", async (e) => {
+  try {
+    const win = BrowserWindow.fromWebContents(e.sender);
+    const stamp = new Date().toISOString().replace(/[:.]/g, "-");
+    const res = await dialog.showSaveDialog(win, { defaultPath: path.join(app.getPath('documents'), `languaggify-trace-${stamp}.json`) });
+    if (res.canceled) return "cancelled";
+    await trace.exportTo(res.filePath);
+    return res.filePath;
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+ipcMain.handle("session-log", async (_, { enable }) => {
+  try {
+    if (enable === true) sessionLog.start();
+    else if (enable === false) await sessionLog.stop();
+    return sessionLog.status();
+  } catch (err) {
+    return "Error: " + err.message;
+  }
+});
+
+
+// LANGUAGGIFY_HEADLESS=1: load the handlers without opening a window (benchmarks)
+if (process.env.LANGUAGGIFY_HEADLESS !== "1") app.whenReady().then(createWindow);
+app.on("will-quit", e => {
+  // the last edits go to the file, and the session log is flushed, before the app exits
+  if (!journalClosed) {
+    e.preventDefault();
+    journalClosed = true;
+    Promise.allSettled([journal.close(), sessionLog.stop()]).finally(() => app.quit());
+    return;
+  }
+  // lab machines: LANGUAGGIFY_TRACE=<file> dumps the trace on exit
+  if (process.env.LANGUAGGIFY_TRACE) {
+    try { fs.writeFileSync(process.env.LANGUAGGIFY_TRACE, JSON.stringify(trace.toJSON())); } catch (er) {}
+  }
+});
 
-app.whenReady().then(createWindow);
+module.exports = { runCode, runExe };
@@ -14,11 +14,55 @@ contextBridge.exposeInMainWorld("api", {
   terminalStop: () => ipcRenderer.invoke("terminal-stop"),
   terminalSave: name => ipcRenderer.invoke("terminal-save", { name }),
   terminalSaveSilent: name => ipcRenderer.invoke("terminal-save-silent", { name }),
+  sessionLog: enable => ipcRenderer.invoke("session-log", { enable }),
+  traceEvents: list => ipcRenderer.send("trace-events", list),
+  traceExport: () => ipcRenderer.invoke("trace-export"),
+  profileRun: (lang, code) => ipcRenderer.invoke("profile-run", { lang, code }),
+  sampleRun: (lang, code) => ipcRenderer.invoke("sample-run", { lang, code }),
+  benchmarkRun: (lang, code, key, warmup, runs) => ipcRenderer.invoke("benchmark-run", { lang, code, key, warmup, runs }),
+  benchmarkHistory: (key, clear) => ipcRenderer.invoke("benchmark-history", { key, clear }),
+  hostCpu: () => ipcRenderer.invoke("host-cpu"),
+  cacheStats: () => ipcRenderer.invoke("cache-stats"),
+  scalingRun: (lang, code, profile, maxThreads, runs) => ipcRenderer.invoke("scaling-run", { lang, code, profile, maxThreads, runs }),
+  pickFolder: title => ipcRenderer.invoke("pick-folder", { title }),
+  testsRun: (lang, code, dir, timeMs, memMB) => ipcRenderer.invoke("tests-run", { lang, code, dir, timeMs, memMB }),
+  onTestEvent: cb => {
+    const listener = (_, ev) => cb(ev);
+    ipcRenderer.on("test-event", listener);
+    return () => ipcRenderer.removeListener("test-event", listener);
+  },
+  gradeRun: (dir, casesDir, timeMs, memMB) => ipcRenderer.invoke("grade-run", { dir, casesDir, timeMs, memMB }),
+  onGradeEvent: cb => {
+    const listener = (_, ev) => cb(ev);
+    ipcRenderer.on("grade-event", listener);
+    return () => ipcRenderer.removeListener("grade-event", listener);
+  },
+  openPath: file => ipcRenderer.invoke("open-path", { file }),
+  debugStart: (lang, code, breakpoints) => ipcRenderer.invoke("debug-start", { lang, code, breakpoints }),
+  debugCmd: cmd => ipcRenderer.invoke("debug-cmd", { cmd }),
+  debugBreak: (line, on) => ipcRenderer.invoke("debug-break", { line, on }),
+  debugVar: (expr, type, name) => ipcRenderer.invoke("debug-var", { expr, type, name }),
+  onDebugEvent: cb => {
+    const listener = (_, ev) => cb(ev);
+    ipcRenderer.on("debug-event", listener);
+    return () => ipcRenderer.removeListener("debug-event", listener);
+  },
+  coverageRun: (lang, code, reset) => ipcRenderer.invoke("coverage-run", { lang, code, reset }),
 
   saveFile: (name, content) =>
     ipcRenderer.invoke("save-file", { name, content }),
   saveFileSilent: (name, content) =>
     ipcRenderer.invoke("save-file-silent", { name, content }),
-  openFile: file => ipcRenderer.invoke("open-file", file)
+  openFile: file => ipcRenderer.invoke("open-file", file),
+  journalRecover: () => ipcRenderer.invoke("journal-recover"),
+  journalBegin: doc => ipcRenderer.invoke("journal-begin", doc),
+  journalAppend: (seq, changes) => ipcRenderer.send("journal-append", { seq, changes }),
+  journalSave: () => ipcRenderer.invoke("journal-save"),
+  pagedOpen: file => ipcRenderer.invoke("paged-open", { file }),
+  pagedRead: (id, start, count) => ipcRenderer.invoke("paged-read", { id, start, count }),
+  pagedFind: (id, text, from) => ipcRenderer.invoke("paged-find", { id, text, from }),
+  pagedText: (id, start, end) => ipcRenderer.invoke("paged-text", { id, start, end }),
+  pagedReplace: (id, start, end, text) => ipcRenderer.invoke("paged-replace", { id, start, end, text }),
+  pagedClose: id => ipcRenderer.invoke("paged-close", { id })
 });
   
\ No newline at end of file
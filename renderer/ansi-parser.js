@@ -0,0 +1,118 @@
+// Streaming ANSI/VT filter for the fallback terminal.
+//
+// feed(chunk) returns the printable text of `chunk` with escape sequences
+// (CSI, OSC, DCS/APC/PM/SOS strings, charset selects, 8-bit C1) removed. The
+// parser is a small state machine: every character is looked at exactly once
+// and a sequence split across chunks is finished on the next feed().
+//
+// Line control is left to the view: '\n' is a newline, a lone '\r' means
+// "back to the start of the line" ("\r\n" collapses to '\n', also across
+// chunks), and '\b' is kept only when it would erase text from an earlier chunk.
+(function (root) {
+  "use strict";
+
+  const GROUND = 0;
+  const ESC = 1;        // after ESC
+  const ESC_INTER = 2;  // ESC + intermediate (e.g. "ESC ( B"), waiting for final
+  const CSI = 3;        // ESC [ ... final
+  const STR = 4;        // OSC/DCS/APC/PM/SOS body, until BEL or ST
+  const STR_ESC = 5;    // ESC inside a string, expecting '\' (ST)
+
+  function printable(c) {
+    return c >= 0x20 && c !== 0x7f && (c < 0x80 || c > 0x9f);
+  }
+
+  // erase the previous character written in this chunk, else leave '\b' for the view
+  function backspace(out) {
+    let k = out.length - 1;
+    while (k >= 0 && out[k].length === 0) k--;
+    const piece = k >= 0 ? out[k] : "";
+    const last = piece.charCodeAt(piece.length - 1);
+    if (k < 0 || last === 0x08) return void out.push("\b");
+    if (last === 0x0a || last === 0x0d) return;
+    out[k] = piece.slice(0, last >= 0xdc00 && last <= 0xdfff && piece.length > 1 ? -2 : -1);
+  }
+
+  class AnsiParser {
+    constructor() {
+      this.reset();
+    }
+
+    reset() {
+      this.state = GROUND;
+      this.pendingCR = false;
+    }
+
+    feed(s) {
+      const out = [];
+      let state = this.state;
+      let cr = this.pendingCR;
+      const n = s.length;
+
+      for (let i = 0; i < n; i++) {
+        let c = s.charCodeAt(i);
+
+        if (state === GROUND) {
+          if (cr) {
+            if (c === 0x0d) continue;   // "\r\r\n" is still a newline
+            cr = false;
+            out.push(c === 0x0a ? "\n" : "\r");
+            if (c === 0x0a) continue;
+          }
+          if (printable(c)) {
+            // copy the whole printable run in one slice
+            const start = i;
+            while (i + 1 < n && printable(s.charCodeAt(i + 1))) i++;
+            out.push(s.slice(start, i + 1));
+            continue;
+          }
+          if (c === 0x0a) out.push("\n");
+          else if (c === 0x09) out.push("\t");
+          else if (c === 0x0d) cr = true;
+          else if (c === 0x08) backspace(out);
+          else if (c === 0x1b) state = ESC;
+          else if (c === 0x9b) state = CSI;
+          else if (c === 0x9d || c === 0x90 || c === 0x98 || c === 0x9e || c === 0x9f) state = STR;
+          // other C0/C1 controls (BEL, NUL, SI/SO, ...) print nothing
+          continue;
+        }
+
+        // CAN/SUB abort any sequence
+        if (c === 0x18 || c === 0x1a) { state = GROUND; continue; }
+
+        switch (state) {
+          case ESC:
+            if (c === 0x5b) state = CSI;                                           // [
+            else if (c === 0x5d || c === 0x50 || c === 0x58 || c === 0x5e || c === 0x5f) state = STR; // ] P X ^ _
+            else if (c >= 0x20 && c <= 0x2f) state = ESC_INTER;
+            else if (c === 0x1b) state = ESC;
+            else state = GROUND;                                                   // two-char escape done
+            break;
+          case ESC_INTER:
+            if (c < 0x20 || c > 0x2f) state = GROUND;
+            break;
+          case CSI:
+            // parameters/intermediates (0x20-0x3f) and stray C0 controls are skipped
+            while (c < 0x40 && c !== 0x1b && c !== 0x18 && c !== 0x1a && i + 1 < n) c = s.charCodeAt(++i);
+            if (c === 0x18 || c === 0x1a) state = GROUND;
+            else if (c === 0x1b) state = ESC;
+            else if (c >= 0x40 && c !== 0x7f) state = GROUND;
+            break;
+          case STR:
+            if (c === 0x07 || c === 0x9c) state = GROUND;
+            else if (c === 0x1b) state = STR_ESC;
+            break;
+          case STR_ESC:
+            state = c === 0x5c ? GROUND : (c === 0x1b ? STR_ESC : STR);
+            break;
+        }
+      }
+      this.state = state;
+      this.pendingCR = cr;
+      return out.join("");
+    }
+  }
+
+  if (typeof module !== "undefined" && module.exports) module.exports = AnsiParser;
+  else root.AnsiParser = AnsiParser;
+})(typeof window !== "undefined" ? window : globalThis);
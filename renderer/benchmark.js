@@ -0,0 +1,92 @@
+// Benchmark view: run settings, the latest result (per-run wall/CPU/RSS and
+// summary statistics) and the result history for the current file.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+
+  const ms = x => (x == null ? "" : x >= 100 ? x.toFixed(0) : x >= 10 ? x.toFixed(1) : x.toFixed(2));
+  const mb = kb => (kb / 1024).toFixed(1) + " MB";
+
+  function summary(res) {
+    const row = (label, s) => el("tr", null,
+      el("td", null, label),
+      el("td", { class: "num" }, ms(s.median)),
+      el("td", { class: "num" }, "±" + ms(s.mad)),
+      el("td", { class: "num" }, ms(s.min)),
+      el("td", { class: "num" }, ms(s.max)));
+    return el("table", { class: "panel-table" },
+      el("tr", null, el("th", null, "ms"), el("th", null, "median"), el("th", null, "MAD"), el("th", null, "min"), el("th", null, "max")),
+      row("wall", res.wall),
+      row("cpu", res.cpu));
+  }
+
+  // one bar per measured run, scaled to the slowest; warmups dimmed
+  function runBars(res) {
+    const max = Math.max(...res.runs.map(r => r.wallMs));
+    return el("div", { class: "bench-bars" }, ...res.runs.map((r, i) => el("div", {
+      class: "bench-bar" + (r.warmup ? " warmup" : ""),
+      style: `height:${Math.max(2, 40 * r.wallMs / max)}px`,
+      title: `${r.warmup ? "warmup" : "run"} ${i}: wall ${ms(r.wallMs)} ms, cpu ${ms(r.cpuMs)} ms (user ${ms(r.userMs)}, sys ${ms(r.sysMs)}), peak ${mb(r.rssKB)}, exit ${r.exit}`
+    })));
+  }
+
+  function history(list) {
+    if (!list.length) return el("div", { class: "panel-note" }, "No results yet for this file.");
+    const rows = list.slice().reverse().map((h, i, all) => {
+      const prev = all[i + 1];
+      const change = prev ? ((h.wall.median / prev.wall.median - 1) * 100) : null;
+      return el("tr", null,
+        el("td", null, new Date(h.date).toLocaleString()),
+        el("td", { title: "source hash" }, h.codeHash),
+        el("td", { class: "num" }, `${ms(h.wall.median)} ±${ms(h.wall.mad)}`),
+        el("td", { class: "num" }, ms(h.cpu.median)),
+        el("td", { class: "num" }, mb(h.rssKB)),
+        el("td", { class: "num " + (change == null ? "" : change < 0 ? "better" : "worse") }, change == null ? "" : (change > 0 ? "+" : "") + change.toFixed(1) + "%"));
+    });
+    return el("table", { class: "panel-table" },
+      el("tr", null, el("th", null, "when"), el("th", null, "code"), el("th", null, "wall ms"), el("th", null, "cpu ms"), el("th", null, "peak"), el("th", null, "Δ")),
+      ...rows);
+  }
+
+  // api: { key, run(warmup, runs) -> result | "Error: ...", history(clear) -> list }
+  root.Benchmark = {
+    async open(api) {
+      const warmup = el("input", { type: "number", min: "0", max: "50", value: "2", class: "bench-num" });
+      const runs = el("input", { type: "number", min: "1", max: "500", value: "10", class: "bench-num" });
+      const go = el("button", null, "▶ Run benchmark");
+      const latest = el("div");
+      const past = el("div");
+      const clear = el("a", { href: "#" }, "clear");
+      const showHistory = list => { past.textContent = ""; past.append(history(list)); };
+
+      go.onclick = async () => {
+        go.disabled = true;
+        latest.textContent = "Running…";
+        try {
+          const res = await api.run(+warmup.value, +runs.value);
+          latest.textContent = "";
+          if (typeof res === "string") return latest.append(el("div", { class: "panel-note" }, res));
+          latest.append(
+            el("div", { class: "panel-note" },
+              `${res.runs.filter(r => !r.warmup).length} runs after ${res.runs.filter(r => r.warmup).length} warmup · ` +
+              (res.cpuPinned >= 0 ? `pinned to CPU ${res.cpuPinned}` : "not pinned") + ` · peak RSS ${mb(res.rssKB)}` +
+              (res.exit ? ` · exit code ${res.exit}` : "") + " · output discarded"),
+            summary(res),
+            runBars(res));
+          showHistory(res.history);
+        } finally {
+          go.disabled = false;
+        }
+      };
+      clear.onclick = async e => { e.preventDefault(); showHistory(await api.history(true)); };
+
+      root.Panel.show("Benchmark — " + api.key, el("div", null,
+        el("div", { class: "bench-form" }, "warmup ", warmup, " runs ", runs, " ", go),
+        latest,
+        el("h4", null, "History ", clear),
+        past));
+      showHistory(await api.history(false));
+    }
+  };
+})(window);
@@ -0,0 +1,61 @@
+// Compile cache panel: this seat's hit rate and, with a lab-wide cache
+// configured, every seat's hit rate and the shared store's size (teacher view);
+// with remote compile configured, the build servers this seat uses.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+
+  const mb = n => (n / 1048576).toFixed(1) + " MB";
+  const rate = (hits, misses) => (hits + misses ? (100 * hits / (hits + misses)).toFixed(0) + "%" : "–");
+
+  function table(head, rows) {
+    return el("table", { class: "panel-table" },
+      el("tr", null, ...head.map(h => el("th", null, h))),
+      ...rows.map(r => el("tr", null, ...r.map((c, i) => el("td", { class: i ? "num" : "name" }, String(c))))));
+  }
+
+  // api: { stats() -> { local, shared, remote } }
+  root.CacheStats = {
+    async open(api) {
+      const body = el("div", null, el("div", { class: "panel-note" }, "Loading…"));
+      root.Panel.show("Compile cache", body);
+      const res = await api.stats();
+      body.textContent = "";
+      if (typeof res === "string") return body.append(el("div", { class: "panel-note" }, res));
+
+      const { local, shared, remote } = res;
+      if (remote) {
+        body.append(el("div", { class: "panel-note" }, "Build servers (remote compile)"),
+          table(["server", "jobs", "failures", "compile ms", "state"], remote.map(s => [s.url, s.jobs, s.failures, s.ms, s.state])));
+      }
+      body.append(el("div", { class: "panel-note" }, "This seat (this session)"),
+        table(["", "hits", "misses", "hit rate", "entries", "size"],
+          [["local", local.hits, local.misses, rate(local.hits, local.misses), local.entries, `${mb(local.bytes)} / ${mb(local.maxBytes)}`]]));
+
+      if (!shared) {
+        return body.append(el("div", { class: "panel-note" },
+          'No lab-wide cache: set "compileCache": { "shared": "<folder or http://server:port>" } in shared-install.json.'));
+      }
+      const { own } = shared;
+      body.append(el("div", { class: "panel-note" }, `Lab cache ${shared.location}${own.writable ? "" : " (read-only on this seat)"}`),
+        table(["", "hits", "misses", "hit rate", "uploads", "errors", "time saved"],
+          [[own.seat, own.hits, own.misses, rate(own.hits, own.misses), own.puts, own.errors, (own.savedMs / 1000).toFixed(1) + " s"]]));
+      if (own.lastError) body.append(el("div", { class: "panel-note" }, "Last error: " + own.lastError));
+      if (!own.sharesStats) {
+        body.append(el("div", { class: "panel-note" },
+          "A read-only folder share keeps no per-seat statistics; the cache server (scripts/compile-cache-server.js) collects them from every seat."));
+      }
+      if (shared.error) return body.append(el("div", { class: "panel-note" }, "Lab statistics unavailable: " + shared.error));
+
+      const { lab } = shared;
+      const seats = lab.seats.sort((a, b) => (b.hits + b.misses) - (a.hits + a.misses));
+      const sum = k => seats.reduce((n, s) => n + (s[k] || 0), 0);
+      body.append(el("div", { class: "panel-note" },
+        `All seats: ${rate(sum("hits"), sum("misses"))} hit rate, ${(sum("savedMs") / 60000).toFixed(1)} min of compiling saved; ` +
+        `${lab.entries} entries, ${mb(lab.bytes)} / ${mb(lab.maxBytes)}`),
+        table(["seat", "hits", "misses", "hit rate", "uploads", "errors", "last report"],
+          seats.map(s => [s.seat, s.hits, s.misses, rate(s.hits, s.misses), s.puts, s.errors, new Date(s.updated).toLocaleString()])));
+    }
+  };
+})(window);
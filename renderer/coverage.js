@@ -0,0 +1,78 @@
+// gcov result view: per-line execution counts as a heatmap in the editor
+// (log-scaled against the hottest line) and a summary in the side panel.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+  let decorations = null;
+
+  // 0 = never executed, 1..5 = log-scaled share of the hottest line
+  function level(count, max) {
+    if (!count) return 0;
+    if (max <= 1) return 1;
+    return 1 + Math.min(4, Math.floor(4 * Math.log(count) / Math.log(max + 1) + 0.5));
+  }
+
+  function short(n) {
+    return n >= 1e9 ? (n / 1e9).toFixed(1) + "G" : n >= 1e6 ? (n / 1e6).toFixed(1) + "M" : n >= 1e4 ? (n / 1e3).toFixed(0) + "k" : String(n);
+  }
+
+  function decorate(editor, result) {
+    clear();
+    const max = Math.max(1, ...result.lines.map(l => l.count));
+    const list = result.lines.map(l => {
+      const lv = level(l.count, max);
+      const delta = result.runs > 1 ? ` (+${l.delta} last run)` : "";
+      return {
+        range: new monaco.Range(l.line, 1, l.line, 1),
+        options: {
+          isWholeLine: true,
+          className: "cov-line-" + lv,
+          glyphMarginClassName: "cov-glyph cov-heat-" + lv,
+          glyphMarginHoverMessage: { value: l.count ? `executed **${l.count}** times${delta}` : "**never executed**" },
+          after: { content: "  ×" + short(l.count), inlineClassName: "cov-inline" }
+        }
+      };
+    });
+    decorations = editor.createDecorationsCollection(list);
+  }
+
+  function clear() {
+    if (decorations) decorations.clear();
+    decorations = null;
+  }
+
+  function jump(editor, line) {
+    return el("a", { href: "#", onclick: e => { e.preventDefault(); editor.revealLineInCenter(line); editor.setPosition({ lineNumber: line, column: 1 }); editor.focus(); } }, "L" + line);
+  }
+
+  root.Coverage = {
+    show(editor, result, rerun) {
+      const { summary } = result;
+      const hot = result.lines.filter(l => l.count).sort((a, b) => b.count - a.count).slice(0, 10);
+      const missed = result.lines.filter(l => !l.count);
+      const fnRows = result.functions.map(f => el("tr", null,
+        el("td", { class: "name" }, f.name),
+        el("td", { class: "num" }, f.calls),
+        el("td", { class: "num" }, `${f.blocksExecuted}/${f.blocks}`),
+        el("td", null, jump(editor, f.line))));
+      const content = el("div", null,
+        el("div", { class: "panel-note" }, `exit code ${result.exitCode} · ${result.runs} run${result.runs > 1 ? "s" : ""} accumulated · `,
+          el("a", { href: "#", onclick: e => { e.preventDefault(); rerun(true); } }, "reset counts")),
+        el("h4", null, `Lines executed: ${summary.executed}/${summary.lines} (${summary.percent}%)`),
+        el("table", { class: "panel-table" },
+          el("tr", null, el("th", null, "function"), el("th", null, "calls"), el("th", null, "blocks"), el("th", null, "")),
+          ...fnRows),
+        el("h4", null, "Hottest lines"),
+        el("table", { class: "panel-table" }, ...hot.map(l => el("tr", null,
+          el("td", null, jump(editor, l.line)),
+          el("td", { class: "num" }, l.count),
+          el("td", { class: "name" }, l.fn || "")))),
+        missed.length ? el("h4", null, "Never executed") : null,
+        missed.length ? el("div", null, ...missed.map(l => [jump(editor, l.line), " "]).flat()) : null);
+      root.Panel.show("Coverage (gcov)", content, clear);
+      decorate(editor, result);
+    },
+    clear
+  };
+})(window);
@@ -0,0 +1,137 @@
+// Debugger UI over the gdb/MI session in main.js: breakpoints toggled in the
+// glyph margin, current-line highlight, and a side panel with run controls,
+// call stack and lazily expanded variables.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+  let editor, api, breakpoints, current = null, active = false;
+  let controls, status, stackEl, varsEl;
+
+  function breakpointLines() {
+    return [...new Set(breakpoints.getRanges().map(r => r.startLineNumber))].sort((a, b) => a - b);
+  }
+
+  function setBreakpoints(lines) {
+    breakpoints.set(lines.map(line => ({
+      range: new monaco.Range(line, 1, line, 1),
+      options: { isWholeLine: false, glyphMarginClassName: "dbg-breakpoint", stickiness: monaco.editor.TrackedRangeStickiness.NeverGrowsWhenTypingAtEdges }
+    })));
+  }
+
+  function toggleBreakpoint(line) {
+    const lines = breakpointLines();
+    const on = !lines.includes(line);
+    setBreakpoints(on ? lines.concat(line) : lines.filter(l => l !== line));
+    if (active) api.debugBreak(line, on);
+  }
+
+  function showLine(line) {
+    if (current) current.clear();
+    current = null;
+    if (!line) return;
+    current = editor.createDecorationsCollection([{
+      range: new monaco.Range(line, 1, line, 1),
+      options: { isWholeLine: true, className: "dbg-current-line", glyphMarginClassName: "dbg-current" }
+    }]);
+    editor.revealLineInCenterIfOutsideViewport(line);
+  }
+
+  // one variable row; composite values and std:: types expand on click
+  function varRow(v, fetch) {
+    const expandable = v.more || v.value === undefined || /\bstd::|__gnu_cxx::/.test(v.type || "");
+    const kids = el("div", { class: "dbg-children" });
+    const twisty = el("span", { class: "dbg-twisty" }, expandable ? "▸" : " ");
+    const row = el("div", { class: "dbg-var", title: v.type || "" }, twisty,
+      el("span", { class: "dbg-name" }, v.name), " = ",
+      el("span", { class: "dbg-value" }, v.value === undefined ? "{…}" : v.value));
+    let open = false;
+    if (expandable) {
+      row.onclick = async () => {
+        open = !open;
+        twisty.textContent = open ? "▾" : "▸";
+        kids.textContent = "";
+        if (!open) return;
+        const list = await fetch();
+        if (typeof list === "string") return kids.append(el("div", { class: "panel-note" }, list));
+        for (const c of list) kids.append(varRow({ name: c.exp, type: c.type, value: c.value, more: c.more }, () => api.debugVar(null, c.type, c.name)));
+      };
+    }
+    return el("div", null, row, kids);
+  }
+
+  function onEvent(ev) {
+    if (ev.state === "running") {
+      status.textContent = "Running…";
+      showLine(null);
+      return;
+    }
+    if (ev.state === "exited" || ev.state === "ended") {
+      if (ev.state === "exited") status.textContent = `Program exited with code ${ev.code}`;
+      else if (active) status.textContent = "Debugger stopped";
+      active = false;
+      showLine(null);
+      controls.classList.add("idle");
+      return;
+    }
+    if (ev.state !== "stopped") return;
+    status.textContent = `Paused${ev.reason ? " (" + ev.reason.replace(/-/g, " ") + ")" : ""}${ev.func ? " in " + ev.func : ""}` +
+      (ev.firstStopMs != null ? ` · first stop after ${ev.firstStopMs} ms` : "");
+    showLine(ev.line);
+    stackEl.textContent = "";
+    for (const f of ev.frames || []) {
+      stackEl.append(el("div", { class: "dbg-frame", onclick: () => f.line && editor.revealLineInCenter(f.line) },
+        `${f.func || "??"}`, f.line ? el("span", { class: "panel-note" }, `  ${f.file || ""}:${f.line}`) : ""));
+    }
+    varsEl.textContent = "";
+    if (ev.error) varsEl.append(el("div", { class: "panel-note" }, ev.error));
+    for (const v of ev.locals || []) varsEl.append(varRow(v, () => api.debugVar(v.name, v.type)));
+  }
+
+  function command(cmd) {
+    if (active) api.debugCmd(cmd);
+  }
+
+  function panel() {
+    const btn = (label, title, cmd) => el("button", { title, onclick: () => command(cmd) }, label);
+    controls = el("div", { class: "dbg-controls" },
+      btn("▶", "Continue (F5)", "continue"),
+      btn("⤼", "Step over (F10)", "next"),
+      btn("⤵", "Step into (F11)", "step"),
+      btn("⤴", "Step out (Shift+F11)", "finish"),
+      btn("■", "Stop", "stop"));
+    status = el("div", { class: "panel-note" }, "Starting…");
+    stackEl = el("div");
+    varsEl = el("div");
+    root.Panel.show("Debugger", el("div", null, controls, status,
+      el("h4", null, "Variables"), varsEl,
+      el("h4", null, "Call stack"), stackEl), () => { if (active) api.debugCmd("stop"); showLine(null); });
+  }
+
+  root.Debugger = {
+    init(ed, ipc) {
+      editor = ed;
+      api = ipc;
+      breakpoints = editor.createDecorationsCollection([]);
+      editor.onMouseDown(e => {
+        if (e.target.type === monaco.editor.MouseTargetType.GUTTER_GLYPH_MARGIN && e.target.position) toggleBreakpoint(e.target.position.lineNumber);
+      });
+      editor.addCommand(monaco.KeyCode.F5, () => command("continue"));
+      editor.addCommand(monaco.KeyCode.F10, () => command("next"));
+      editor.addCommand(monaco.KeyCode.F11, () => command("step"));
+      editor.addCommand(monaco.KeyMod.Shift | monaco.KeyCode.F11, () => command("finish"));
+      api.onDebugEvent(ev => { if (controls) onEvent(ev); });
+    },
+    async start(lang) {
+      panel();
+      const res = await api.debugStart(lang, editor.getValue(), breakpointLines());
+      if (typeof res === "string" && res.startsWith("Error")) {
+        status.textContent = res;
+        return;
+      }
+      active = true;
+      controls.classList.remove("idle");
+      if (!breakpointLines().length) status.textContent = "Running… (click the gutter left of a line number to add a breakpoint)";
+    }
+  };
+})(window);
@@ -0,0 +1,103 @@
+// Sampling profile view: an icicle-style flame graph (main at the top, callees
+// below) in the side panel, and per-line sample counts in the editor gutter.
+// Clicking a frame zooms into it and jumps to its hottest source line.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+  const ROW = 18;
+  const MIN_PX = 2;
+  let decorations = null;
+
+  // stable warm colour per function; DLL frames are grey
+  function color(name) {
+    if (/\.(dll|so(\.\d+)*|exe)(\+0x[0-9a-f]+)?$/i.test(name) || name === "[unknown]") return "hsl(0, 0%, 38%)";
+    let h = 0;
+    for (let i = 0; i < name.length; i++) h = (h * 31 + name.charCodeAt(i)) | 0;
+    return `hsl(${10 + (Math.abs(h) % 45)}, 70%, ${45 + (Math.abs(h >> 8) % 12)}%)`;
+  }
+
+  function hottestLine(node) {
+    let best = null;
+    for (const [line, n] of Object.entries(node.lines)) if (!best || n > node.lines[best]) best = line;
+    return best ? +best : null;
+  }
+
+  function depth(node) {
+    return 1 + node.children.reduce((d, c) => Math.max(d, depth(c)), 0);
+  }
+
+  function render(box, editor, top, total, intervalMs) {
+    box.textContent = "";
+    const width = box.clientWidth || 560;
+    box.style.height = depth(top) * ROW + "px";
+    const place = (node, x, d) => {
+      const w = width * node.value / top.value;
+      if (w < MIN_PX) return;
+      const pct = (100 * node.value / total).toFixed(1);
+      const line = hottestLine(node);
+      const frame = el("div", {
+        class: "flame-frame",
+        style: `left:${x}px;top:${d * ROW}px;width:${Math.max(0, w - 1)}px;background:${color(node.name)}`,
+        title: `${node.name}\n${node.value} samples (${pct}%), ~${(node.value * intervalMs).toFixed(0)} ms` +
+          (node.self ? `\nself ${node.self} samples` : "") + (line ? `\nhottest line ${line}` : "")
+      }, w > 30 ? node.name : "");
+      frame.onclick = () => {
+        if (line) { editor.revealLineInCenter(line); editor.setPosition({ lineNumber: line, column: 1 }); }
+        render(box, editor, node === top ? topOf(box) : node, total, intervalMs);
+      };
+      box.append(frame);
+      let cx = x;
+      for (const c of node.children.slice().sort((a, b) => b.value - a.value)) {
+        place(c, cx, d + 1);
+        cx += width * c.value / top.value;
+      }
+    };
+    place(top, 0, 0);
+  }
+
+  // clicking the current top frame zooms back out to the whole profile
+  const roots = new WeakMap();
+  function topOf(box) {
+    return roots.get(box);
+  }
+
+  function decorate(editor, lines, samples) {
+    clear();
+    const max = Math.max(1, ...lines.map(l => l.self));
+    decorations = editor.createDecorationsCollection(lines.filter(l => l.self || l.total).map(l => {
+      const lv = l.self ? 1 + Math.min(3, Math.floor(4 * l.self / max)) : 1;
+      return {
+        range: new monaco.Range(l.line, 1, l.line, 1),
+        options: {
+          isWholeLine: true,
+          className: "prof-line-" + lv,
+          glyphMarginClassName: "prof-glyph prof-heat-" + lv,
+          glyphMarginHoverMessage: { value: `**${(100 * l.self / samples).toFixed(1)}%** of samples on this line, ${(100 * l.total / samples).toFixed(1)}% with it on the stack` },
+          after: l.self ? { content: `  ● ${(100 * l.self / samples).toFixed(1)}%`, inlineClassName: "prof-inline" } : undefined
+        }
+      };
+    }));
+  }
+
+  function clear() {
+    if (decorations) decorations.clear();
+    decorations = null;
+  }
+
+  root.FlameGraph = {
+    show(editor, result) {
+      const box = el("div", { class: "flame" });
+      const content = el("div", null,
+        el("div", { class: "panel-note" },
+          `exit code ${result.exitCode} · ${result.samples} samples, ~${result.intervalMs} ms each` +
+          (result.dropped ? ` · ${result.dropped} dropped (buffer full)` : "") + " · click a frame to zoom"),
+        result.samples ? box : el("div", { class: "panel-note" }, "No samples: the program ran too briefly to be measured."));
+      root.Panel.show("Sampling profile", content, clear, { width: 560 });
+      roots.set(box, result.tree);
+      if (result.samples) render(box, editor, result.tree, result.samples, result.intervalMs);
+      decorate(editor, result.lines, Math.max(1, result.samples));
+    },
+    clear
+  };
+})(window);
@@ -0,0 +1,67 @@
+// Bulk grading panel: submissions folder + test-case folder in, progress while
+// the submissions are built and run, links to the CSV/HTML report out.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+
+  function folderPicker(api, key, title, fallbackKey) {
+    let dir = localStorage.getItem(key) || (fallbackKey && localStorage.getItem(fallbackKey)) || "";
+    const label = el("span", { class: "panel-note" }, dir || "not chosen");
+    const btn = el("button", null, "📂");
+    btn.onclick = async () => {
+      const res = await api.pickFolder(title);
+      if (!res || res === "cancelled") return;
+      dir = res;
+      localStorage.setItem(key, dir);
+      label.textContent = dir;
+    };
+    return { node: el("div", { class: "bench-form" }, title.split(" (")[0] + " ", btn, " ", label), get: () => dir };
+  }
+
+  // api: { pickFolder(title), run(dir, casesDir, timeMs, memMB), onEvent(cb), openPath(file) }
+  root.Grading = {
+    open(api) {
+      const subs = folderPicker(api, "grade.dir", "Submissions (*.c, *.cpp, *.py, *.js)");
+      const cases = folderPicker(api, "grade.cases", "Test cases (*.in / *.out)", "tests.dir");
+      const timeMs = el("input", { type: "number", min: "100", step: "100", value: localStorage.getItem("tests.timeMs") || "2000", class: "bench-num" });
+      const memMB = el("input", { type: "number", min: "0", step: "16", value: localStorage.getItem("tests.memMB") || "256", class: "bench-num" });
+      const go = el("button", null, "▶ Grade all");
+      const bar = el("div", { class: "grade-bar" });
+      const status = el("div", { class: "panel-note" });
+      const log = el("div", { class: "grade-log" });
+
+      const off = api.onEvent(p => {
+        bar.style.width = (100 * p.done / p.total).toFixed(1) + "%";
+        status.textContent = `${p.done}/${p.total} distinct submissions`;
+        log.prepend(el("div", { class: p.status === "ok" ? "" : "grade-bad" },
+          `${p.files.join(", ")}: ${p.status === "ok" ? `${p.passed}/${p.cases}` : p.status}`));
+      });
+
+      go.onclick = async () => {
+        if (!subs.get() || !cases.get()) return (status.textContent = "Choose both folders first.");
+        go.disabled = true;
+        log.textContent = "";
+        bar.style.width = "0";
+        status.textContent = "Building…";
+        try {
+          const res = await api.run(subs.get(), cases.get(), +timeMs.value, +memMB.value);
+          if (typeof res === "string") return (status.textContent = res);
+          status.textContent = "";
+          status.append(`${res.files} files (${res.unique} distinct) graded in ${(res.wallMs / 1000).toFixed(1)} s · `,
+            el("a", { href: "#", onclick: e => { e.preventDefault(); api.openPath(res.html); } }, "HTML report"), " · ",
+            el("a", { href: "#", onclick: e => { e.preventDefault(); api.openPath(res.csv); } }, "CSV"));
+        } finally {
+          go.disabled = false;
+        }
+      };
+
+      root.Panel.show("Grading", el("div", null,
+        subs.node, cases.node,
+        el("div", { class: "bench-form" }, "time ms ", timeMs, " memory MB ", memMB, " ", go),
+        el("div", { class: "grade-track" }, bar),
+        status,
+        log), off);
+    }
+  };
+})(window);
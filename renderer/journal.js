@@ -0,0 +1,93 @@
+// Autosave: feeds Monaco's content-change deltas to the edit journal in main
+// (lib/edit-journal.js) in small batches. A file's journal starts when it is
+// opened or saved; an untitled buffer's starts with its first edit, so an
+// untouched buffer leaves nothing behind. Replacing the buffer (setValue)
+// starts a new document.
+(function (root) {
+  "use strict";
+
+  const FLUSH_MS = 250;
+
+  // api: { begin(doc), append(seq, changes), save() }; docOf() -> { file, lang }
+  root.Journal = {
+    attach(editor, api, docOf) {
+      let doc = null;
+      let state = "idle"; // idle (untitled, unedited) | starting | on | off
+      let untitledBase = null;
+      let pending = [];
+      let seq = 0;
+      let timer = null;
+
+      function flush() {
+        clearTimeout(timer);
+        timer = null;
+        if (state !== "on" || !pending.length) return;
+        api.append(seq++, pending);
+        pending = [];
+      }
+
+      async function start(d) {
+        const mine = doc;
+        let ok = await api.begin(d);
+        // the editor normalized the file (line breaks, BOM): its text becomes the base
+        if (ok === false && doc === mine) {
+          pending = [];
+          ok = await api.begin({ ...d, content: editor.getValue() });
+        }
+        if (doc !== mine) return false;
+        if (ok !== true) console.error("edit journal:", ok);
+        state = ok === true ? "on" : "off";
+        if (state === "on" && pending.length) flush();
+        else pending = [];
+        return state === "on";
+      }
+
+      // after the document changed: opened, saved under a name, replaced
+      function reset() {
+        flush();
+        doc = docOf();
+        pending = [];
+        seq = 0;
+        if (doc.file) {
+          state = "starting";
+          start({ ...doc, length: editor.getModel().getValueLength() });
+        } else {
+          state = "idle";
+          untitledBase = editor.getValue();
+        }
+      }
+
+      editor.onDidChangeModelContent(e => {
+        if (e.isFlush) return reset();
+        if (state === "off") return;
+        if (state === "idle") {
+          state = "starting";
+          start({ ...doc, content: untitledBase });
+          untitledBase = null;
+        }
+        for (const c of e.changes) pending.push([c.rangeOffset, c.rangeLength, c.text]);
+        if (state === "on" && !timer) timer = setTimeout(flush, FLUSH_MS);
+      });
+      root.addEventListener("beforeunload", flush);
+      reset();
+
+      return {
+        reset,
+        // write the buffer to its file now; false when it has none (or journaling is off)
+        async save() {
+          if (!doc.file || state !== "on") return false;
+          flush();
+          const res = await api.save();
+          if (typeof res !== "string" || !res.startsWith("Error")) return res;
+          // main dropped the journal (or could not write it): start over from
+          // the whole buffer, which writes it to the file
+          const file = doc.file;
+          pending = [];
+          seq = 0;
+          state = "starting";
+          return (await start({ ...doc, content: editor.getValue() })) ? file : res;
+        }
+      };
+    }
+  };
+})(window);
@@ -0,0 +1,192 @@
+// Read-only paged viewer for files too large for the editor
+// (lib/paged-file.js). It takes the editor's place; only the rows on screen
+// exist in the DOM and only a few pages of lines are kept, so a 200 MB CSV
+// costs what a small one does. "Edit" loads a window of lines into the editor;
+// saving it streams the change back into the file.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+
+  const ROW = 18;            // px per line
+  const PAGE = 200;          // lines per request
+  const MAX_PAGES = 40;      // pages cached
+  const MAX_PX = 8_000_000;  // tallest scroll area; beyond it scrolling is proportional
+  const EDIT_LINES = 1000;
+
+  const size = n => (n >= 1073741824 ? (n / 1073741824).toFixed(1) + " GB" : (n / 1048576).toFixed(1) + " MB");
+
+  // api: { open(file), read(id, start, count), find(id, text, from), text(id, start, end) -> { text }, close(id) }
+  // hooks: { editorEl, onEdit({ id, start, end, text, name }), onClose() }
+  root.PagedView = {
+    async open(api, file, hooks) {
+      const info = await api.open(file);
+      if (typeof info === "string") return alert(info);
+      const id = info.id;
+      const name = file.split(/[\\/]/).pop();
+      let total = Math.max(info.total, 1);
+      let complete = info.complete;
+      let mark = -1;
+      const pages = new Map(); // page -> { lines, cut } (insertion order = LRU)
+      const loading = new Set();
+
+      const status = el("span", { class: "panel-note" });
+      const gotoInput = el("input", { type: "number", min: "1", placeholder: "line", class: "bench-num" });
+      const findInput = el("input", { type: "search", placeholder: "find" });
+      const editBtn = el("button", { title: `Load ${EDIT_LINES} lines from the top of the view into the editor` }, "✎ Edit");
+      const closeBtn = el("button", { title: "Close the file" }, "✕");
+      const spacer = el("div", { class: "paged-spacer" });
+      const rows = el("div", { class: "paged-rows" });
+      const scroller = el("div", { class: "paged-scroll" }, spacer, rows);
+      const view = el("div", { id: "pagedView" },
+        el("div", { class: "paged-head" }, el("b", null, name), status, "Go to ", gotoInput, findInput, editBtn, closeBtn),
+        scroller);
+      hooks.editorEl.after(view);
+
+      const visible = () => Math.max(1, Math.ceil(scroller.clientHeight / ROW));
+      const height = () => Math.min(total * ROW, MAX_PX);
+      // scroll position <-> first line shown (proportional once the area is capped)
+      function firstLine() {
+        const range = height() - scroller.clientHeight;
+        if (range <= 0) return 0;
+        return Math.min(total - 1, Math.max(0, Math.round(scroller.scrollTop / range * Math.max(0, total - visible()))));
+      }
+      function scrollTo(line) {
+        const range = height() - scroller.clientHeight;
+        scroller.scrollTop = range <= 0 ? 0 : line / Math.max(1, total - visible()) * range;
+        render();
+      }
+
+      function showStatus() {
+        status.textContent = `${size(info.size)} · ${complete ? "" : "indexing… "}${total.toLocaleString()} lines`;
+      }
+
+      async function load(page) {
+        if (loading.has(page)) return;
+        loading.add(page);
+        try {
+          const res = await api.read(id, page * PAGE, PAGE);
+          if (typeof res === "string") return (status.textContent = res);
+          pages.set(page, { lines: res.lines, cut: new Set(res.cut) });
+          while (pages.size > MAX_PAGES) pages.delete(pages.keys().next().value);
+          if (res.total !== total || res.complete !== complete) {
+            total = Math.max(res.total, 1);
+            complete = res.complete;
+            showStatus();
+          }
+          render();
+        } finally {
+          loading.delete(page);
+        }
+      }
+
+      let frame = 0;
+      function render() {
+        frame = 0;
+        spacer.style.height = height() + "px";
+        rows.style.top = scroller.scrollTop + "px";
+        const first = firstLine();
+        const n = visible();
+        const digits = String(total).length;
+        const out = [];
+        for (let line = first; line < Math.min(first + n, total); line++) {
+          const page = pages.get(Math.floor(line / PAGE));
+          if (!page) {
+            load(Math.floor(line / PAGE));
+            out.push(el("div", { class: "paged-row" }, el("span", { class: "paged-num" }, String(line + 1).padStart(digits))));
+            continue;
+          }
+          const i = line % PAGE;
+          const text = page.lines[i];
+          if (text === undefined) continue; // past the end (index still growing)
+          out.push(el("div", { class: "paged-row" + (line === mark ? " paged-mark" : "") },
+            el("span", { class: "paged-num" }, String(line + 1).padStart(digits)), text,
+            page.cut.has(i) ? el("span", { class: "panel-note" }, " … (line cut)") : null));
+        }
+        rows.replaceChildren(...out);
+      }
+      scroller.addEventListener("scroll", () => {
+        if (!frame) frame = requestAnimationFrame(render);
+      });
+      const onResize = () => render();
+      window.addEventListener("resize", onResize);
+
+      gotoInput.addEventListener("keydown", e => {
+        if (e.key !== "Enter" || !gotoInput.value) return;
+        mark = Math.min(total, Math.max(1, +gotoInput.value)) - 1;
+        scrollTo(mark);
+      });
+      findInput.addEventListener("keydown", async e => {
+        if (e.key !== "Enter" || !findInput.value) return;
+        status.textContent = "searching…";
+        const from = mark >= 0 && mark >= firstLine() ? mark + 1 : firstLine();
+        const line = await api.find(id, findInput.value, from);
+        showStatus();
+        if (typeof line === "string") return (status.textContent = line);
+        if (line < 0) return (status.textContent = `"${findInput.value}" not found below line ${from + 1}`);
+        mark = line;
+        scrollTo(line);
+      });
+
+      // pages before the edit are still valid, the rest is dropped
+      function invalidate(fromLine) {
+        for (const page of [...pages.keys()]) if ((page + 1) * PAGE > fromLine) pages.delete(page);
+      }
+
+      // line count while the index is being built
+      const poll = setInterval(async () => {
+        const res = await api.read(id, 0, 1);
+        if (typeof res === "string") return;
+        total = Math.max(res.total, 1);
+        complete = res.complete;
+        if (complete) clearInterval(poll);
+        showStatus();
+        render();
+      }, 500);
+
+      function show(line) {
+        hooks.editorEl.style.display = "none";
+        view.style.display = "flex";
+        if (line !== undefined) {
+          mark = line;
+          scrollTo(line);
+        }
+        render();
+      }
+
+      editBtn.onclick = async () => {
+        const start = firstLine();
+        const end = Math.min(total, start + EDIT_LINES);
+        const res = await api.text(id, start, end);
+        if (typeof res === "string") return alert(res);
+        const { text } = res;
+        view.style.display = "none";
+        hooks.editorEl.style.display = "";
+        hooks.onEdit({ id, start, end, text, name });
+      };
+
+      function close() {
+        clearInterval(poll);
+        window.removeEventListener("resize", onResize);
+        view.remove();
+        hooks.editorEl.style.display = "";
+        api.close(id);
+        hooks.onClose();
+      }
+      closeBtn.onclick = close;
+
+      showStatus();
+      show(0);
+      return {
+        show,
+        close,
+        // after an edited window was written back: lines [start, start + count)
+        edited(start, oldEnd, count) {
+          total += count - (oldEnd - start);
+          invalidate(start);
+          showStatus();
+        }
+      };
+    }
+  };
+})(window);
@@ -0,0 +1,59 @@
+// Dockable side panel over the right edge of the editor, shared by the
+// analysis views (profile, coverage, tests, ...). One view at a time.
+(function (root) {
+  "use strict";
+
+  let panel, titleEl, bodyEl, onClose = null;
+
+  function ensure() {
+    if (panel) return;
+    panel = document.createElement("div");
+    panel.id = "sidePanel";
+    panel.innerHTML = '<div class="panel-head"><span class="panel-title"></span><button class="panel-close" title="Close">✕</button></div><div class="panel-body"></div>';
+    titleEl = panel.querySelector(".panel-title");
+    bodyEl = panel.querySelector(".panel-body");
+    panel.querySelector(".panel-close").onclick = () => Panel.hide();
+    document.body.appendChild(panel);
+  }
+
+  // small DOM helper: el("td", { class: "num" }, "1.23")
+  function el(tag, attrs, ...children) {
+    const node = document.createElement(tag);
+    for (const [k, v] of Object.entries(attrs || {})) {
+      if (v == null || v === false) continue; // boolean attributes: absent
+      if (k === "class") node.className = v;
+      else if (k.startsWith("on")) node.addEventListener(k.slice(2), v);
+      else node.setAttribute(k, v === true ? "" : v);
+    }
+    for (const c of children) if (c != null) node.append(c.nodeType ? c : String(c));
+    return node;
+  }
+
+  const Panel = {
+    el,
+    // show `content` (node or string) under `title`; `close` runs when the panel is dismissed
+    show(title, content, close, { width = 380 } = {}) {
+      ensure();
+      if (onClose) onClose();
+      onClose = close || null;
+      panel.style.width = width + "px";
+      titleEl.textContent = title;
+      bodyEl.textContent = "";
+      bodyEl.append(content.nodeType ? content : String(content));
+      panel.style.display = "flex";
+      return bodyEl;
+    },
+    hide() {
+      if (!panel) return;
+      panel.style.display = "none";
+      if (onClose) onClose();
+      onClose = null;
+    },
+    body() {
+      ensure();
+      return bodyEl;
+    }
+  };
+
+  root.Panel = Panel;
+})(window);
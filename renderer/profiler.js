@@ -0,0 +1,79 @@
+// gprof result view: flat profile and call graph in the side panel, and
+// per-function self time as gutter decorations on the function's first line.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+  let decorations = null;
+
+  function heat(percent) {
+    return percent >= 40 ? 4 : percent >= 15 ? 3 : percent >= 5 ? 2 : 1;
+  }
+
+  function fmt(n, digits = 2) {
+    return n == null ? "" : Number(n).toFixed(digits);
+  }
+
+  function lineLink(editor, line) {
+    if (!line) return "";
+    return el("a", { href: "#", onclick: e => { e.preventDefault(); editor.revealLineInCenter(line); editor.setPosition({ lineNumber: line, column: 1 }); editor.focus(); } }, "L" + line);
+  }
+
+  function decorate(editor, flat) {
+    clear();
+    const list = flat.filter(r => r.line && r.self > 0).map(r => ({
+      range: new monaco.Range(r.line, 1, r.line, 1),
+      options: {
+        isWholeLine: true,
+        className: "prof-line-" + heat(r.percent),
+        glyphMarginClassName: "prof-glyph prof-heat-" + heat(r.percent),
+        glyphMarginHoverMessage: { value: `**${r.name}** — ${fmt(r.percent, 1)}% self time (${fmt(r.self)} s${r.calls != null ? `, ${r.calls} calls` : ""})` },
+        after: { content: `  ⏱ ${fmt(r.percent, 1)}% self`, inlineClassName: "prof-inline" }
+      }
+    }));
+    decorations = editor.createDecorationsCollection(list);
+  }
+
+  function clear() {
+    if (decorations) decorations.clear();
+    decorations = null;
+  }
+
+  function flatTable(editor, flat) {
+    const head = el("tr", null, el("th", null, "function"), el("th", null, "% time"), el("th", null, "self s"), el("th", null, "calls"), el("th", null, "ms/call"), el("th", null, ""));
+    const rows = flat.map(r => el("tr", { class: "heat-" + heat(r.percent) },
+      el("td", { class: "name" }, r.name),
+      el("td", { class: "num" }, fmt(r.percent, 1)),
+      el("td", { class: "num" }, fmt(r.self)),
+      el("td", { class: "num" }, r.calls == null ? "" : r.calls),
+      el("td", { class: "num" }, fmt(r.totalMsPerCall)),
+      el("td", null, lineLink(editor, r.line))));
+    return el("table", { class: "panel-table" }, head, ...rows);
+  }
+
+  function callGraph(editor, nodes) {
+    const wrap = el("div", { class: "callgraph" });
+    for (const n of nodes.filter(n => n.percent > 0 || n.called)) {
+      const edge = (arrow, e) => el("div", { class: "edge" }, `${arrow} ${e.name}`, e.called ? ` (${e.called})` : "");
+      wrap.append(el("details", { open: n.percent >= 5 },
+        el("summary", null, `${n.name}  ${fmt(n.percent, 1)}%  self ${fmt(n.self)} s  children ${fmt(n.children)} s `, lineLink(editor, n.line)),
+        ...n.callers.map(c => edge("←", c)),
+        ...n.callees.map(c => edge("→", c))));
+    }
+    return wrap;
+  }
+
+  root.Profiler = {
+    show(editor, result) {
+      const content = el("div", null,
+        el("div", { class: "panel-note" }, `exit code ${result.exitCode}` + (result.sampleSeconds ? ` · each sample ${result.sampleSeconds} s` : "")),
+        el("h4", null, "Flat profile"),
+        result.flat.length ? flatTable(editor, result.flat) : el("div", { class: "panel-note" }, "No samples: the program ran too briefly to be measured."),
+        el("h4", null, "Call graph"),
+        callGraph(editor, result.callGraph));
+      root.Panel.show("Profile (gprof)", content, clear);
+      decorate(editor, result.flat);
+    },
+    clear
+  };
+})(window);
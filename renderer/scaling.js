@@ -0,0 +1,84 @@
+// OpenMP scaling view: the program built with an OpenMP profile and timed at
+// 1, 2, 4, ... threads, plotted as speedup against the ideal (linear) line.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+  const SVG_NS = "http://www.w3.org/2000/svg";
+
+  const ms = x => (x >= 100 ? x.toFixed(0) : x >= 10 ? x.toFixed(1) : x.toFixed(2));
+
+  function svg(tag, attrs, ...children) {
+    const node = document.createElementNS(SVG_NS, tag);
+    for (const [k, v] of Object.entries(attrs || {})) node.setAttribute(k, v);
+    for (const c of children) node.append(c);
+    return node;
+  }
+
+  // speedup (y) against threads (x), both linear from 0 to the largest thread count
+  function plot(points) {
+    const W = 340, H = 220, L = 30, B = 24, T = 8, R = 8;
+    const maxT = points[points.length - 1].threads;
+    const maxY = Math.max(maxT, ...points.map(p => p.speedup));
+    const x = t => L + (W - L - R) * t / maxT;
+    const y = s => H - B - (H - B - T) * s / maxY;
+    const g = svg("svg", { class: "scaling-plot", width: W, height: H, viewBox: `0 0 ${W} ${H}` });
+    g.append(svg("line", { x1: L, y1: H - B, x2: W - R, y2: H - B, class: "axis" }),
+      svg("line", { x1: L, y1: T, x2: L, y2: H - B, class: "axis" }));
+    for (const p of points) {
+      g.append(svg("text", { x: x(p.threads), y: H - B + 14, "text-anchor": "middle" }, String(p.threads)));
+    }
+    const step = Math.max(1, Math.ceil(maxY / 4));
+    for (let s = step; s <= maxY; s += step) {
+      g.append(svg("text", { x: L - 4, y: y(s) + 4, "text-anchor": "end" }, s + "×"));
+    }
+    g.append(svg("line", { x1: x(0), y1: y(0), x2: x(maxT), y2: y(maxT), class: "ideal" }));
+    g.append(svg("polyline", { points: points.map(p => `${x(p.threads)},${y(p.speedup)}`).join(" "), class: "measured" }));
+    for (const p of points) {
+      g.append(svg("circle", { cx: x(p.threads), cy: y(p.speedup), r: 3, class: "measured" },
+        svg("title", null, `${p.threads} threads: ${p.speedup.toFixed(2)}× (${(100 * p.efficiency).toFixed(0)}% efficiency)`)));
+    }
+    return g;
+  }
+
+  function table(points) {
+    return el("table", { class: "panel-table" },
+      el("tr", null, el("th", null, "threads"), el("th", null, "wall ms"), el("th", null, "cpu ms"), el("th", null, "speedup"), el("th", null, "efficiency")),
+      ...points.map(p => el("tr", null,
+        el("td", { class: "num" }, String(p.threads)),
+        el("td", { class: "num" }, `${ms(p.wall.median)} ±${ms(p.wall.mad)}`),
+        el("td", { class: "num" }, ms(p.cpu.median)),
+        el("td", { class: "num" }, p.speedup.toFixed(2) + "×"),
+        el("td", { class: "num " + (p.efficiency >= 0.75 ? "better" : p.efficiency < 0.5 ? "worse" : "") }, (100 * p.efficiency).toFixed(0) + "%"))));
+  }
+
+  // api: { cores, profile (label), run(maxThreads, runs) -> { points } | "Error: ..." }
+  root.Scaling = {
+    open(api) {
+      const maxThreads = el("input", { type: "number", min: "1", max: "256", value: String(api.cores), class: "bench-num" });
+      const runs = el("input", { type: "number", min: "1", max: "100", value: "5", class: "bench-num" });
+      const go = el("button", null, "▶ Run scaling");
+      const result = el("div");
+
+      go.onclick = async () => {
+        go.disabled = true;
+        result.textContent = `Building (${api.profile}) and running…`;
+        try {
+          const res = await api.run(+maxThreads.value, +runs.value);
+          result.textContent = "";
+          if (typeof res === "string") return result.append(el("div", { class: "panel-note" }, res));
+          result.append(
+            el("div", { class: "panel-note" }, `median of ${runs.value} runs per thread count · OMP_NUM_THREADS set per run · dashed line is ideal scaling`),
+            plot(res.points),
+            table(res.points));
+        } finally {
+          go.disabled = false;
+        }
+      };
+
+      root.Panel.show("Scaling — " + api.profile, el("div", null,
+        el("div", { class: "bench-form" }, "up to ", maxThreads, " threads, runs ", runs, " ", go),
+        result));
+    }
+  };
+})(window);
@@ -0,0 +1,92 @@
+// Test-case panel: pick a folder of <name>.in / <name>.out pairs, run them
+// all in parallel and fill in pass/fail, time, memory and diffs as each case
+// finishes.
+(function (root) {
+  "use strict";
+
+  const { el } = root.Panel;
+  const LABEL = { pass: "✔ pass", fail: "✘ wrong", ran: "● ran", time: "⏱ time", memory: "▣ memory", output: "✘ output limit", crash: "✘ crash", error: "✘ error" };
+
+  function diffView(r) {
+    if (r.diff) {
+      return el("pre", { class: "test-diff" }, ...r.diff.map(o => o.op === "…"
+        ? el("div", { class: "ctx" }, "  …")
+        : el("div", { class: o.op === "-" ? "del" : o.op === "+" ? "add" : "ctx" }, `${o.op} ${o.text}`)));
+    }
+    const text = r.output != null ? r.output : r.stderr;
+    return text ? el("pre", { class: "test-diff" }, text) : el("div", { class: "panel-note" }, "no output");
+  }
+
+  // api: { pickFolder() -> path | "cancelled", run(dir, timeMs, memMB) -> summary | "Error: ...", onEvent(cb) }
+  root.Tests = {
+    open(api) {
+      let dir = localStorage.getItem("tests.dir") || "";
+      const dirEl = el("span", { class: "panel-note" }, dir || "no folder chosen");
+      const pick = el("button", null, "📂 Folder…");
+      const timeMs = el("input", { type: "number", min: "100", step: "100", value: localStorage.getItem("tests.timeMs") || "2000", class: "bench-num" });
+      const memMB = el("input", { type: "number", min: "0", step: "16", value: localStorage.getItem("tests.memMB") || "256", class: "bench-num" });
+      const go = el("button", null, "▶ Run tests");
+      const summary = el("div", { class: "panel-note" });
+      const table = el("table", { class: "panel-table" });
+      let rows = [];
+
+      pick.onclick = async () => {
+        const res = await api.pickFolder();
+        if (!res || res === "cancelled") return;
+        dir = res;
+        localStorage.setItem("tests.dir", dir);
+        dirEl.textContent = dir;
+      };
+
+      const off = api.onEvent(ev => {
+        if (ev.type === "start") {
+          table.textContent = "";
+          table.append(el("tr", null, el("th", null, "case"), el("th", null, "result"), el("th", null, "ms"), el("th", null, "MB")));
+          rows = ev.cases.map(name => {
+            const status = el("td", { class: "test-status" }, "…");
+            const ms = el("td", { class: "num" });
+            const mb = el("td", { class: "num" });
+            const row = el("tr", null, el("td", { class: "name" }, name), status, ms, mb);
+            const detail = el("tr", { class: "test-detail" });
+            table.append(row, detail);
+            return { row, status, ms, mb, detail };
+          });
+        } else if (ev.type === "result" && rows[ev.index]) {
+          const r = ev.result, ui = rows[ev.index];
+          ui.status.textContent = LABEL[r.status] || r.status;
+          ui.row.className = "test-" + r.status;
+          ui.ms.textContent = r.wallMs != null ? r.wallMs.toFixed(0) : "";
+          ui.mb.textContent = r.rssKB ? (r.rssKB / 1024).toFixed(1) : "";
+          if (r.status !== "pass") {
+            ui.row.style.cursor = "pointer";
+            ui.row.onclick = () => {
+              if (ui.detail.firstChild) return (ui.detail.textContent = "");
+              ui.detail.append(el("td", { colspan: "4" }, diffView(r)));
+            };
+          }
+        }
+      });
+
+      go.onclick = async () => {
+        if (!dir) return pick.onclick();
+        localStorage.setItem("tests.timeMs", timeMs.value);
+        localStorage.setItem("tests.memMB", memMB.value);
+        go.disabled = true;
+        summary.textContent = "Building…";
+        try {
+          const res = await api.run(dir, +timeMs.value, +memMB.value);
+          if (typeof res === "string") return (summary.textContent = res);
+          summary.textContent = `${res.passed}/${res.total} passed in ${(res.wallMs / 1000).toFixed(2)} s`;
+        } finally {
+          go.disabled = false;
+        }
+      };
+
+      root.Panel.show("Tests", el("div", null,
+        el("div", { class: "bench-form" }, pick, " ", dirEl),
+        el("div", { class: "bench-form" }, "time ms ", timeMs, " memory MB ", memMB, " ", go),
+        summary,
+        table), off);
+    }
+  };
+})(window);
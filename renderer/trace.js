@@ -0,0 +1,35 @@
+// Renderer half of lib/trace.js: records spans with the same wall-clock
+// microsecond timestamps and ships them to the main process in batches.
+(function (root) {
+  "use strict";
+
+  const queue = [];
+  let timer = null;
+
+  function now() {
+    return Math.round((performance.timeOrigin + performance.now()) * 1000);
+  }
+
+  function flush() {
+    timer = null;
+    if (!queue.length || !root.api || !root.api.traceEvents) return;
+    root.api.traceEvents(queue.splice(0));
+  }
+
+  function push(ev) {
+    queue.push(ev);
+    if (!timer) timer = setTimeout(flush, 250);
+  }
+
+  root.RendererTrace = {
+    now,
+    span(name, args) {
+      const ts = now();
+      return more => push({ name, ph: "X", ts, dur: now() - ts, args: more ? Object.assign({}, args, more) : args });
+    },
+    instant(name, args) {
+      push({ name, ph: "i", ts: now(), args });
+    },
+    flush
+  };
+})(window);
@@ -0,0 +1,129 @@
+// Line-based terminal view used when xterm.js is not available.
+//
+// Output is kept as an array of lines (bounded to `maxLines`) and only the rows
+// inside the viewport are in the DOM, so appending is O(chunk) and a frame costs
+// O(visible rows) no matter how much output has been written. Rendering is
+// batched to one pass per animation frame.
+(function (root) {
+  "use strict";
+
+  class VirtualTerminal {
+    constructor(el, opts = {}) {
+      this.el = el;
+      this.maxLines = opts.maxLines || 200_000;
+      this.lines = [""];
+      this.dropped = 0;          // lines discarded from the front so far
+      this.follow = true;        // stick to the bottom while output arrives
+      this.pending = false;
+
+      el.textContent = "";
+      el.style.overflow = "auto";
+      el.style.position = "relative";
+      el.style.whiteSpace = "pre";
+
+      this.spacer = document.createElement("div");
+      this.rows = document.createElement("div");
+      this.rows.style.position = "absolute";
+      this.rows.style.left = "0";
+      this.rows.style.right = "0";
+      el.appendChild(this.spacer);
+      el.appendChild(this.rows);
+
+      this.rowHeight = this.measureRow();
+      el.addEventListener("scroll", () => {
+        this.follow = el.scrollTop + el.clientHeight >= el.scrollHeight - this.rowHeight;
+        this.schedule();
+      });
+      if (typeof ResizeObserver !== "undefined") new ResizeObserver(() => this.schedule()).observe(el);
+    }
+
+    measureRow() {
+      const probe = document.createElement("div");
+      probe.textContent = "M";
+      this.rows.appendChild(probe);
+      const h = probe.getBoundingClientRect().height || 16;
+      this.rows.removeChild(probe);
+      return h;
+    }
+
+    // append filtered text (see ansi-parser.js): '\n' starts a new line, '\r'
+    // restarts the current one, '\b' erases its last character
+    write(txt) {
+      if (!txt) return;
+      const lines = this.lines;
+      if (txt.indexOf("\r") < 0 && txt.indexOf("\b") < 0) {
+        const parts = txt.split("\n");
+        lines[lines.length - 1] += parts[0];
+        for (let i = 1; i < parts.length; i++) lines.push(parts[i]);
+      } else {
+        for (const part of txt.split(/([\n\r\b])/)) {
+          const last = lines.length - 1;
+          if (part === "\n") lines.push("");
+          else if (part === "\r") lines[last] = "";
+          else if (part === "\b") lines[last] = lines[last].slice(0, -1);
+          else lines[last] += part;
+        }
+      }
+      this.trim();
+      this.schedule();
+    }
+
+    // drop old lines in blocks so the array shift is amortised
+    trim() {
+      const over = this.lines.length - this.maxLines;
+      if (over <= 0) return;
+      const n = over + (this.maxLines >> 4);
+      this.lines.splice(0, n);
+      this.dropped += n;
+      if (!this.follow) this.el.scrollTop = Math.max(0, this.el.scrollTop - n * this.rowHeight);
+    }
+
+    clear() {
+      this.lines = [""];
+      this.dropped = 0;
+      this.schedule();
+    }
+
+    text() {
+      return this.lines.join("\n");
+    }
+
+    schedule() {
+      if (this.pending) return;
+      this.pending = true;
+      requestAnimationFrame(() => {
+        this.pending = false;
+        this.render();
+      });
+    }
+
+    render() {
+      const el = this.el;
+      const h = this.rowHeight;
+      this.spacer.style.height = (this.lines.length * h) + "px";
+      if (this.follow) el.scrollTop = el.scrollHeight;
+
+      const first = Math.max(0, Math.floor(el.scrollTop / h) - 2);
+      const count = Math.ceil(el.clientHeight / h) + 4;
+      const last = Math.min(this.lines.length, first + count);
+
+      // reuse row nodes; only their text changes between frames
+      const nodes = this.rows.childNodes;
+      while (nodes.length < last - first) {
+        const row = document.createElement("div");
+        row.style.height = h + "px";   // keeps empty lines from collapsing
+        this.rows.appendChild(row);
+      }
+      while (nodes.length > last - first) this.rows.removeChild(this.rows.lastChild);
+      for (let i = first; i < last; i++) {
+        const node = nodes[i - first];
+        const line = this.lines[i];
+        if (node.textContent !== line) node.textContent = line;
+      }
+      this.rows.style.top = (first * h) + "px";
+    }
+  }
+
+  if (typeof module !== "undefined" && module.exports) module.exports = VirtualTerminal;
+  else root.VirtualTerminal = VirtualTerminal;
+})(typeof window !== "undefined" ? window : globalThis);
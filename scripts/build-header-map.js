@@ -0,0 +1,114 @@
+// Build the header resolution map used by languages/c.js and cpp.js (see
+// lib/headermap.js). Run at install time, after scripts/split-toolchain.js
+// on a lean install, and again whenever the toolchain changes; a map built
+// for another compiler is ignored.
+//
+// Usage: node scripts/build-header-map.js [--bin "c c++/bin"] [--out "c c++/include-map"]
+//
+// For C and C++ it asks the compiler for its search chain, resolves every
+// header under it the way `#include <name>` would (first directory wins) and
+// hard-links the result into <out>/<lang> (copies with the original mtime
+// where links are not possible). A header is left out when it uses
+// #include_next, or when a quoted include in it would find a different file
+// from the map than from its own directory.
+const fs = require("fs");
+const path = require("path");
+const { searchChain } = require("../lib/headermap");
+const { toolchainId } = require("../lib/hostcpu");
+
+const ROOT = path.join(__dirname, "..");
+const LANGS = { c: "gcc", "c++": "g++" };
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+function walk(dir, rel = "", out = []) {
+  let ents;
+  try { ents = fs.readdirSync(path.join(dir, rel), { withFileTypes: true }); } catch (_) { return out; }
+  for (const ent of ents) {
+    const r = rel ? rel + "/" + ent.name : ent.name;
+    if (ent.isDirectory()) walk(dir, r, out);
+    else if (ent.isFile()) out.push(r);
+  }
+  return out;
+}
+
+// -> Map(name -> { dir, file, quoted: [names], next }) with the first directory winning
+function resolveAll(chain) {
+  const map = new Map();
+  for (const dir of chain) {
+    for (const rel of walk(dir)) {
+      if (map.has(rel)) continue;
+      const file = path.join(dir, rel);
+      const src = fs.readFileSync(file, "latin1");
+      map.set(rel, {
+        dir,
+        file,
+        next: /^\s*#\s*include_next\b/m.test(src),
+        quoted: [...src.matchAll(/^\s*#\s*include\s*"([^"]+)"/gm)].map(m => path.posix.normalize(path.posix.join(path.posix.dirname(rel), m[1])))
+      });
+    }
+  }
+  return map;
+}
+
+// names safe to serve from the map directory (fixpoint over quoted includes)
+function selectHeaders(map) {
+  const keep = new Set([...map.keys()].filter(name => !map.get(name).next));
+  for (let changed = true; changed;) {
+    changed = false;
+    for (const name of keep) {
+      const { dir, quoted } = map.get(name);
+      // from the map dir, "x" is looked up next to the map copy first: it must
+      // be the file next to the original, or absent so the chain is searched
+      const ok = quoted.every(q => (fs.existsSync(path.join(dir, q)) ? keep.has(q) && map.get(q).dir === dir : !keep.has(q)));
+      if (!ok) {
+        keep.delete(name);
+        changed = true;
+      }
+    }
+  }
+  return keep;
+}
+
+function place(src, dest) {
+  fs.mkdirSync(path.dirname(dest), { recursive: true });
+  try {
+    fs.linkSync(src, dest);
+    return "link";
+  } catch (_) {
+    fs.copyFileSync(src, dest);
+    const st = fs.statSync(src);
+    fs.utimesSync(dest, st.atime, st.mtime); // #pragma once compares size and mtime
+    return "copy";
+  }
+}
+
+async function main() {
+  const bin = path.resolve(arg("bin", path.join(ROOT, "c c++", "bin")));
+  const out = path.resolve(arg("out", path.join(ROOT, "c c++", "include-map")));
+  const exe = name => (fs.existsSync(path.join(bin, name + ".exe")) ? path.join(bin, name + ".exe") : path.join(bin, name));
+
+  fs.rmSync(out, { recursive: true, force: true });
+  const manifest = { date: new Date().toISOString(), toolchain: toolchainId(exe("gcc")), langs: {} };
+  for (const [lang, driver] of Object.entries(LANGS)) {
+    const chain = await searchChain(exe(driver), lang);
+    const map = resolveAll(chain);
+    const keep = selectHeaders(map);
+    const how = { link: 0, copy: 0 };
+    for (const name of keep) how[place(map.get(name).file, path.join(out, lang, name))]++;
+    const excluded = [...map.keys()].filter(n => !keep.has(n)).sort();
+    manifest.langs[lang] = { chain, headers: keep.size, linked: how.link, copied: how.copy, excluded };
+    console.log(`${lang.padEnd(4)} ${chain.length} dirs  ${String(map.size).padStart(6)} headers  ${String(keep.size).padStart(6)} mapped  ${excluded.length} left to the chain` +
+      (how.copy ? `  (${how.copy} copied)` : ""));
+  }
+  fs.writeFileSync(path.join(out, "manifest.json"), JSON.stringify(manifest, null, 2));
+  console.log("map: " + out);
+}
+
+main().catch(err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
@@ -0,0 +1,104 @@
+// HTTP stand-in for the lab-wide compile cache directory (lib/compile-cache.js),
+// for labs without a writable file share. Seats point "compileCache.shared" in
+// shared-install.json (or LANGUAGGIFY_COMPILE_CACHE) at http://<server>:<port>.
+//
+// Usage: node scripts/compile-cache-server.js [--dir compile-cache-lab] [--port 8765] [--max-mb 4096]
+//                                             [--token <secret>]
+//
+//   GET  /<key>          cached exe (X-Compile-Ms: compile time it saves), 404 on a miss
+//   PUT  /<key>          store an exe (Authorization: Bearer <token>), 403 otherwise
+//   PUT  /stats/<seat>   a seat's hit/miss counters
+//   GET  /stats          every seat's counters plus the store size (teacher view)
+//
+// Cached programs run on every seat, so only the holder of the token (or
+// LANGUAGGIFY_COMPILE_CACHE_TOKEN) may add them: the teacher machine or a
+// build server, which get it in their environment. Never put it in
+// shared-install.json, which students can read. Without a token the cache is
+// read-only.
+const crypto = require("crypto");
+const fs = require("fs");
+const http = require("http");
+const path = require("path");
+const { DirStore, MB } = require("../lib/compile-cache");
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+const store = new DirStore(path.resolve(arg("dir", "compile-cache-lab")), { maxBytes: +arg("max-mb", 4096) * MB });
+const port = +arg("port", 8765);
+const KEY = /^\/([0-9a-f]{32})$/;
+const MAX_BODY = 256 * MB;
+const token = arg("token", process.env.LANGUAGGIFY_COMPILE_CACHE_TOKEN || "");
+
+const digest = s => crypto.createHash("sha256").update(String(s)).digest();
+function mayWrite(req) {
+  const m = /^Bearer (.+)$/.exec(req.headers.authorization || "");
+  return !!token && !!m && crypto.timingSafeEqual(digest(m[1]), digest(token));
+}
+
+function send(res, status, body, type = "text/plain") {
+  res.writeHead(status, { "Content-Type": type });
+  res.end(body);
+}
+
+function readBody(req) {
+  return new Promise((resolve, reject) => {
+    const chunks = [];
+    let size = 0;
+    req.on("data", c => {
+      size += c.length;
+      if (size > MAX_BODY) req.destroy(new Error("body too large"));
+      else chunks.push(c);
+    });
+    req.on("end", () => resolve(Buffer.concat(chunks)));
+    req.on("error", reject);
+  });
+}
+
+async function handle(req, res) {
+  const url = decodeURIComponent(req.url.split("?")[0]);
+  const key = KEY.exec(url);
+
+  if (req.method === "GET" && url === "/stats") return send(res, 200, JSON.stringify(await store.labStats()), "application/json");
+
+  if (req.method === "PUT" && url.startsWith("/stats/")) {
+    const counters = JSON.parse((await readBody(req)).toString("utf8"));
+    await store.report(url.slice("/stats/".length), counters);
+    return send(res, 204, "");
+  }
+
+  if (req.method === "GET" && key) {
+    const file = store.file(key[1]);
+    if (!fs.existsSync(file)) return send(res, 404, "miss");
+    let meta = {};
+    try { meta = JSON.parse(fs.readFileSync(file.replace(/\.exe$/, ".json"), "utf8")); } catch (_) {}
+    const now = new Date();
+    fs.utimes(file, now, now, () => {}); // LRU
+    res.writeHead(200, { "Content-Type": "application/octet-stream", "X-Compile-Ms": String(meta.ms || 0) });
+    return fs.createReadStream(file).on("error", err => res.destroy(err)).pipe(res);
+  }
+
+  if (req.method === "PUT" && key) {
+    if (!mayWrite(req)) {
+      req.resume();
+      return send(res, 403, token ? "bad upload token" : "read-only cache");
+    }
+    const tmp = path.join(store.dir, `upload-${process.pid}-${Date.now()}-${Math.random().toString(36).slice(2)}.tmp`);
+    fs.mkdirSync(store.dir, { recursive: true });
+    fs.writeFileSync(tmp, await readBody(req));
+    try {
+      await store.put(key[1], tmp, { ms: +req.headers["x-compile-ms"] || 0 });
+    } finally {
+      fs.rmSync(tmp, { force: true });
+    }
+    return send(res, 204, "");
+  }
+
+  send(res, 404, "not found");
+}
+
+http.createServer((req, res) => {
+  handle(req, res).catch(err => send(res, 500, err.message));
+}).listen(port, () => console.log(`compile cache: ${store.dir} (max ${store.maxBytes / MB} MB${token ? "" : ", read-only"}) on http://localhost:${port}`));
@@ -0,0 +1,132 @@
+// Build daemon for remote compile (lib/remote-compile.js). Run it on the
+// teacher machine (or any spare PC) from the same install as the seats; seats
+// list it in "remoteCompile": { "servers": [...] } of shared-install.json or
+// LANGUAGGIFY_REMOTE_COMPILE=http://host:port[,http://host2:port].
+//
+// Usage: node scripts/compile-server.js [--port 8766] [--jobs <cores>] [--queue <2 x jobs>]
+//
+//   GET  /info      { toolchain, jobs, active, queued }
+//   POST /compile   body: preprocessed source; X-Lang: c | c++, X-Flags: JSON
+//                   array, X-Toolchain: the seat's hostcpu.toolchainDigest()
+//                   200 object file (X-Warnings: compiler output)
+//                   409 other toolchain, 400 flag not allowed, 503 queue full,
+//                   422 compile error (body: diagnostics)
+//
+// Only compile flags on the allow list are passed on (no plugins, specs,
+// output paths or response files), and the input is always preprocessed
+// source, so a seat cannot make the server read or write its own files.
+// -march=native is refused: it would target the server's CPU, not the seat's.
+const { execFile } = require("child_process");
+const fs = require("fs");
+const http = require("http");
+const os = require("os");
+const path = require("path");
+const hostcpu = require("../lib/hostcpu");
+const install = require("../lib/install");
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+const port = +arg("port", 8766);
+const jobs = +arg("jobs", os.cpus().length);
+const maxQueue = +arg("queue", 2 * jobs);
+const MAX_BODY = 64 * 1024 * 1024;
+const work = fs.mkdtempSync(path.join(os.tmpdir(), "languaggify-compile-"));
+
+const LANGS = {
+  c: { driver: "gcc.exe", input: "cpp-output", ext: ".i" },
+  "c++": { driver: "g++.exe", input: "c++-cpp-output", ext: ".ii" }
+};
+const ALLOWED = /^-(std=[\w+]+|O[0-3sgz]?|g[0-3]?|w|pedantic(-errors)?|m(32|64)|m(arch|tune)=(?!native\b)[\w.-]+|W(?!l,|a,|p,)[\w=+-]*|[DU]\w+(=[\w().,+-]*)?|f(?!plugin|dump|profile|record|debug-prefix|file-prefix|macro-prefix)[\w+-]+(=[\w.,+-]+)?)$/;
+
+let active = 0;
+const queue = [];
+let seq = 0;
+
+function slot() {
+  if (active < jobs) {
+    active++;
+    return Promise.resolve();
+  }
+  return new Promise(resolve => queue.push(resolve));
+}
+
+function release() {
+  const next = queue.shift();
+  if (next) next();
+  else active--;
+}
+
+function readBody(req) {
+  return new Promise((resolve, reject) => {
+    const chunks = [];
+    let size = 0;
+    req.on("data", c => {
+      size += c.length;
+      if (size > MAX_BODY) req.destroy(new Error("body too large"));
+      else chunks.push(c);
+    });
+    req.on("end", () => resolve(Buffer.concat(chunks)));
+    req.on("error", reject);
+  });
+}
+
+function send(res, status, body, headers = {}) {
+  res.writeHead(status, { "Content-Type": "text/plain; charset=utf-8", "X-Queued": String(queue.length), ...headers });
+  res.end(body);
+}
+
+async function compile(req, res) {
+  const lang = LANGS[req.headers["x-lang"]];
+  let flags;
+  try { flags = JSON.parse(req.headers["x-flags"] || "[]"); } catch (_) {}
+  if (!lang || !Array.isArray(flags)) return send(res, 400, "bad request");
+  const bad = flags.find(f => typeof f !== "string" || !ALLOWED.test(f));
+  if (bad !== undefined) return send(res, 400, "flag not allowed: " + bad);
+  const toolchain = await hostcpu.toolchainDigest();
+  if (req.headers["x-toolchain"] !== toolchain) return send(res, 409, "toolchain " + toolchain);
+  if (queue.length >= maxQueue) return send(res, 503, "busy");
+
+  const source = await readBody(req);
+  await slot();
+  const base = path.join(work, `job-${++seq}`);
+  const started = Date.now();
+  try {
+    fs.writeFileSync(base + lang.ext, source);
+    const compiler = path.join(install.dir("toolchain"), "bin", lang.driver);
+    const args = ["-x", lang.input, ...flags, "-c", "-o", base + ".o", base + lang.ext];
+    const { e, out } = await new Promise(resolve => execFile(compiler, args, { timeout: 120_000, windowsHide: true, maxBuffer: 4 * 1024 * 1024 },
+      (e, stdout, stderr) => resolve({ e, out: String(stderr || stdout || "").trim() })));
+    if (e) return send(res, 422, out || e.message);
+    const object = fs.readFileSync(base + ".o");
+    console.log(`${req.socket.remoteAddress} ${req.headers["x-lang"]} ${(source.length / 1024).toFixed(0)} KB -> ${(object.length / 1024).toFixed(0)} KB in ${Date.now() - started} ms`);
+    send(res, 200, object, { "Content-Type": "application/octet-stream", "X-Warnings": encodeURIComponent(out.slice(0, 8000)) });
+  } finally {
+    release();
+    for (const ext of [lang.ext, ".o"]) fs.rm(base + ext, { force: true }, () => {});
+  }
+}
+
+async function handle(req, res) {
+  const url = req.url.split("?")[0];
+  if (req.method === "GET" && url === "/info") {
+    return send(res, 200, JSON.stringify({ toolchain: await hostcpu.toolchainDigest(), jobs, active, queued: queue.length }),
+      { "Content-Type": "application/json" });
+  }
+  if (req.method === "POST" && url === "/compile") return compile(req, res);
+  send(res, 404, "not found");
+}
+
+hostcpu.toolchainDigest().then(toolchain => {
+  http.createServer((req, res) => {
+    handle(req, res).catch(err => send(res, 500, err.message));
+  }).listen(port, () => console.log(`compile server: ${jobs} jobs, toolchain ${toolchain.slice(0, 16)} on http://localhost:${port}`));
+}).catch(err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
+
+process.on("exit", () => fs.rmSync(work, { recursive: true, force: true }));
+process.on("SIGINT", () => process.exit(0));
@@ -0,0 +1,81 @@
+// Write install-manifest/ for a shared (read-only, network) install; see
+// lib/install.js. Run on the install after every change to it (toolchain
+// split, header map, Monaco trim, updates) and before making it read-only.
+//
+// Usage: node scripts/install-manifest.js [tree ...]   (default: every tree present)
+//
+// install-manifest/<tree>.json lists every file with size, mtime and sha256;
+// files hard-linked to an earlier file of the tree (the header map) are
+// recorded as links. index.json maps each tree to the digest of its list,
+// which is what seats compare against their local copy.
+const crypto = require("crypto");
+const fs = require("fs");
+const path = require("path");
+const install = require("../lib/install");
+
+function walk(dir, rel = "", out = []) {
+  for (const ent of fs.readdirSync(path.join(dir, rel), { withFileTypes: true })) {
+    const r = rel ? rel + "/" + ent.name : ent.name;
+    if (ent.isDirectory()) walk(dir, r, out);
+    else if (ent.isFile()) out.push(r);
+  }
+  return out;
+}
+
+async function hashFile(file) {
+  const h = crypto.createHash("sha256");
+  for await (const chunk of fs.createReadStream(file)) h.update(chunk);
+  return h.digest("hex");
+}
+
+async function manifestOf(tree) {
+  const root = path.join(install.APP, install.TREES[tree]);
+  const inodes = new Map(); // dev:ino -> first path
+  const files = [];
+  let bytes = 0;
+  for (const rel of walk(root).sort()) {
+    const st = fs.statSync(path.join(root, rel), { bigint: true });
+    const id = `${st.dev}:${st.ino}`;
+    if (st.nlink > 1n && inodes.has(id)) {
+      files.push({ path: rel, link: inodes.get(id) });
+      continue;
+    }
+    inodes.set(id, rel);
+    // mtime: whole ms (cut off, not rounded), as hostcpu.toolchainId() reads it
+    files.push({ path: rel, size: Number(st.size), mtime: Number(st.mtimeMs), sha256: await hashFile(path.join(root, rel)) });
+    bytes += Number(st.size);
+  }
+  const h = crypto.createHash("sha256");
+  for (const f of files) h.update(`${f.path}\0${f.link || f.sha256}\0`);
+  return { tree, dir: install.TREES[tree], date: new Date().toISOString(), digest: h.digest("hex"), bytes, files };
+}
+
+async function main() {
+  const trees = process.argv.slice(2).length ? process.argv.slice(2) : Object.keys(install.TREES);
+  for (const tree of trees) if (!install.TREES[tree]) throw new Error("unknown tree " + tree);
+  fs.mkdirSync(install.MANIFEST_DIR, { recursive: true });
+  const indexFile = path.join(install.MANIFEST_DIR, "index.json");
+  let index = {};
+  try { index = JSON.parse(fs.readFileSync(indexFile, "utf8")); } catch (_) {}
+
+  for (const tree of trees) {
+    if (!fs.existsSync(path.join(install.APP, install.TREES[tree]))) {
+      delete index[tree];
+      fs.rmSync(path.join(install.MANIFEST_DIR, tree + ".json"), { force: true });
+      continue;
+    }
+    const start = Date.now();
+    const m = await manifestOf(tree);
+    fs.writeFileSync(path.join(install.MANIFEST_DIR, tree + ".json"), JSON.stringify(m));
+    index[tree] = m.digest;
+    const links = m.files.filter(f => f.link).length;
+    console.log(`${tree.padEnd(11)} ${String(m.files.length).padStart(6)} files${links ? ` (${links} links)` : ""}  ` +
+      `${(m.bytes / 1048576).toFixed(1).padStart(7)} MB  ${m.digest.slice(0, 16)}  ${((Date.now() - start) / 1000).toFixed(1)} s`);
+  }
+  fs.writeFileSync(indexFile, JSON.stringify(index, null, 2));
+}
+
+main().catch(err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
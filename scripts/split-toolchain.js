@@ -0,0 +1,114 @@
+// Split the bundled toolchain into a lean core and on-demand components.
+//
+// Usage:
+//   node scripts/split-toolchain.js [--keep gdb,tools]   pack and remove optional components
+//   node scripts/split-toolchain.js --restore            extract every pack (back to the full layout)
+//   node scripts/split-toolchain.js --measure            size / scan figures of the current layout
+//
+// Meant for building an install or lab image, not for the git tree. The core
+// left in `c c++/` is gcc, g++, cpp, binutils needed to assemble and link,
+// headers and the x86_64 libraries; the components listed in
+// lib/components.js go to `c c++/components/<name>.pack` and are extracted by
+// the app when a feature first needs them (debugger, profiler, -m32, ...).
+//
+// Before and after it reports install size, file count, executables (.exe
+// and .dll) and the time to read and hash all of those, which is what an
+// on-access virus scanner does on first launch. Run --measure after a reboot
+// (or flush the file cache) for cold figures.
+const crypto = require("crypto");
+const fs = require("fs");
+const path = require("path");
+const components = require("../lib/components");
+
+const ROOT = components.TOOLCHAIN;
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+function walk(dir, out = []) {
+  for (const ent of fs.readdirSync(dir, { withFileTypes: true })) {
+    const p = path.join(dir, ent.name);
+    if (ent.isDirectory()) walk(p, out);
+    else out.push(p);
+  }
+  return out;
+}
+
+// remove directories left empty by the split
+function pruneEmpty(dir) {
+  for (const ent of fs.readdirSync(dir, { withFileTypes: true })) {
+    if (ent.isDirectory()) pruneEmpty(path.join(dir, ent.name));
+  }
+  if (dir !== ROOT && !fs.readdirSync(dir).length) fs.rmdirSync(dir);
+}
+
+function measure() {
+  const files = walk(ROOT).filter(f => !f.startsWith(components.PACK_DIR + path.sep));
+  const exes = files.filter(f => /\.(exe|dll)$/i.test(f));
+  const start = process.hrtime.bigint();
+  for (const f of exes) crypto.createHash("sha256").update(fs.readFileSync(f)).digest();
+  return {
+    files: files.length,
+    bytes: files.reduce((n, f) => n + fs.statSync(f).size, 0),
+    executables: exes.length,
+    executableBytes: exes.reduce((n, f) => n + fs.statSync(f).size, 0),
+    scanMs: Number(process.hrtime.bigint() - start) / 1e6
+  };
+}
+
+const mb = n => (n / 1048576).toFixed(1) + " MB";
+const line = (label, m) =>
+  console.log(`${label.padEnd(8)} ${mb(m.bytes).padStart(9)}  ${String(m.files).padStart(6)} files  ` +
+    `${String(m.executables).padStart(4)} exe/dll (${mb(m.executableBytes)})  scan ${m.scanMs.toFixed(0)} ms`);
+
+async function main() {
+  if (!fs.existsSync(path.join(ROOT, "bin"))) throw new Error("toolchain not found at " + ROOT);
+
+  if (process.argv.includes("--measure")) return line("current", measure());
+
+  if (process.argv.includes("--restore")) {
+    for (const name of Object.keys(components.COMPONENTS)) {
+      const file = path.join(components.PACK_DIR, name + ".pack");
+      if (!fs.existsSync(file)) continue;
+      const count = await components.extract(file, ROOT);
+      console.log(`${name.padEnd(10)} ${count} files restored`);
+    }
+    fs.rmSync(components.PACK_DIR, { recursive: true, force: true });
+    return;
+  }
+
+  const keep = String(arg("keep", "")).split(",").filter(Boolean);
+  for (const name of keep) if (!components.COMPONENTS[name]) throw new Error("unknown component " + name);
+  if (fs.existsSync(components.PACK_DIR)) throw new Error("already split; run with --restore first");
+  // the map hard-links headers, which would keep packed ones on disk
+  if (fs.existsSync(path.join(ROOT, "include-map"))) throw new Error("remove c c++/include-map first and rebuild it after the split");
+
+  const before = measure();
+  fs.mkdirSync(components.PACK_DIR);
+  const packs = {};
+  for (const [name, c] of Object.entries(components.COMPONENTS)) {
+    if (keep.includes(name)) continue;
+    const files = components.filesOf(name);
+    if (!files.length) continue;
+    const res = await components.pack(path.join(components.PACK_DIR, name + ".pack"), ROOT, files);
+    for (const rel of files) fs.rmSync(path.join(ROOT, rel));
+    packs[name] = { title: c.title, ...res };
+    console.log(`${name.padEnd(10)} ${String(res.files).padStart(5)} files  ${mb(res.bytes).padStart(9)} -> ${mb(res.packed).padStart(9)}  ${c.title}`);
+  }
+  pruneEmpty(ROOT);
+  const after = measure();
+
+  fs.writeFileSync(path.join(components.PACK_DIR, "manifest.json"),
+    JSON.stringify({ date: new Date().toISOString(), kept: keep, packs, before, after }, null, 2));
+  const packed = Object.values(packs).reduce((n, p) => n + p.packed, 0);
+  line("before", before);
+  line("after", after);
+  console.log(`packs    ${mb(packed).padStart(9)}  (installed size with packs ${mb(after.bytes + packed)})`);
+}
+
+main().catch(err => {
+  console.error("Error: " + err.message);
+  process.exit(1);
+});
@@ -0,0 +1,180 @@
+// Build a trimmed copy of the Monaco bundle for the IDE.
+//
+// Usage: node scripts/trim-monaco.js [outDir] [--ts-worker <ts.worker-*.js>]   (default: monaco-min)
+//
+// The IDE only edits javascript, python, c and cpp. The trimmed bundle keeps
+// the editor core, those four tokenizers (preloaded together with the editor)
+// and the TypeScript/JS language service. The service needs the bundle's
+// ts.worker, which the vendored monaco/ does not carry: pass the one from the
+// same monaco-editor release (min/vs/assets) with --ts-worker, otherwise the
+// IDE turns JS language features off (index.html). The other basic-language tokenizers
+// are copied as-is and stay lazily loaded on first use. The css/html/json
+// language services, their workers and the non-English nls packs are dropped;
+// their contribution modules are replaced by empty stubs so editor.main still
+// resolves its dependency list.
+const fs = require("fs");
+const path = require("path");
+
+function arg(name, def) {
+  const i = process.argv.indexOf("--" + name);
+  return i >= 0 ? process.argv[i + 1] : def;
+}
+
+const ROOT = path.join(__dirname, "..");
+const SRC = path.join(ROOT, "monaco", "vs");
+const positional = process.argv.slice(2).filter((a, i, all) => !a.startsWith("--") && !(all[i - 1] || "").startsWith("--"));
+const OUT = path.resolve(ROOT, positional[0] || "monaco-min", "vs");
+const TS_WORKER = arg("ts-worker");
+
+// languages offered by the `lang` select in index.html
+const CORE_LANGS = ["javascript", "python", "c", "cpp"];
+// language services the IDE never uses (their contribution exports monaco_contribution)
+const DROPPED_SERVICES = ["css", "html", "json"];
+const PRELOAD_MODULE = "vs/languaggify-preload";
+
+function walk(dir, base = dir, out = []) {
+  for (const ent of fs.readdirSync(dir, { withFileTypes: true })) {
+    const p = path.join(dir, ent.name);
+    if (ent.isDirectory()) walk(p, base, out);
+    else out.push(path.relative(base, p).split(path.sep).join("/"));
+  }
+  return out;
+}
+
+function sizeOf(dir, files) {
+  return files.reduce((n, f) => n + fs.statSync(path.join(dir, f)).size, 0);
+}
+
+function read(rel) {
+  return fs.readFileSync(path.join(SRC, rel), "utf8");
+}
+
+// "vs/foo/bar" + "../baz" -> "baz.js" (path relative to SRC)
+function resolveModule(fromRel, dep) {
+  if (!dep.startsWith(".")) return null;
+  return path.posix.normalize(path.posix.join(path.posix.dirname(fromRel), dep)) + ".js";
+}
+
+// static define() deps plus lazy require(["./x"]) calls
+function depsOf(rel) {
+  const src = read(rel);
+  const deps = [];
+  const def = /^define\("[^"]*",\[([^\]]*)\]/.exec(src);
+  if (def) for (const m of def[1].matchAll(/"([^"]+)"/g)) deps.push(m[1]);
+  for (const m of src.matchAll(/\(\["(\.\.?\/[^"]+)"\]/g)) deps.push(m[1]);
+  return deps.map(d => resolveModule(rel, d)).filter(Boolean);
+}
+
+// id -> module file of each tokenizer registered by basic-languages/monaco.contribution
+function basicLanguages() {
+  const src = read("basic-languages/monaco.contribution.js");
+  const map = {};
+  for (const m of src.matchAll(/\{id:"([^"]+)"[^]*?a\(\["(\.\.\/[^"]+)"\]/g)) {
+    map[m[1]] = resolveModule("basic-languages/monaco.contribution.js", m[2]);
+  }
+  return map;
+}
+
+// contribution modules that register one of the dropped language services
+function droppedContributions(files) {
+  return files.filter(f => /^monaco\.contribution-[^/]+\.js$/.test(f)).filter(f => {
+    const src = read(f);
+    return DROPPED_SERVICES.some(id => src.includes(`languageId:"${id}"`) || src.includes(`register({id:"${id}"`) || src.includes(`"./${id}Mode-`));
+  });
+}
+
+function isTrimOutput(dir) {
+  try {
+    return JSON.parse(fs.readFileSync(path.join(dir, "manifest.json"), "utf8")).preload === PRELOAD_MODULE;
+  } catch (_) {
+    return false;
+  }
+}
+
+function main() {
+  if (!fs.existsSync(SRC)) throw new Error("Monaco bundle not found at " + SRC);
+  const all = walk(SRC);
+  const langs = basicLanguages();
+  const stubs = new Set(droppedContributions(all));
+
+  const keep = new Set();
+  const visit = rel => {
+    if (keep.has(rel) || !all.includes(rel)) return;
+    keep.add(rel);
+    if (!stubs.has(rel)) depsOf(rel).forEach(visit);
+  };
+
+  ["loader.js", "nls.messages-loader.js", "editor/editor.main.js", "editor/editor.main.css",
+    "language/typescript/monaco.contribution.js"].forEach(visit);
+  const coreModules = CORE_LANGS.map(id => {
+    if (!langs[id]) throw new Error("No tokenizer registered for " + id);
+    visit(langs[id]);
+    return langs[id];
+  });
+  // other tokenizers stay in the bundle but are only fetched when first used
+  Object.keys(langs).filter(id => !CORE_LANGS.includes(id)).forEach(id => visit(langs[id]));
+  // workers are referenced by URL, not by define()
+  all.filter(f => /^assets\/(editor|ts)\.worker-/.test(f)).forEach(f => keep.add(f));
+
+  // the output directory is replaced: never the app, the source bundle or a parent of either
+  const outDir = path.dirname(OUT);
+  const inside = (dir, parent) => !path.relative(parent, dir).split(path.sep).includes("..") && !path.isAbsolute(path.relative(parent, dir));
+  if (inside(ROOT, outDir) || inside(outDir, path.dirname(SRC))) throw new Error("refusing to replace " + outDir);
+  // and only a directory this script made (or an empty one), and only what it writes there
+  const previous = fs.existsSync(outDir) ? fs.readdirSync(outDir) : [];
+  if (previous.length && !isTrimOutput(outDir)) throw new Error(`${outDir} is not empty and not a trimmed bundle; pick another directory`);
+  fs.rmSync(OUT, { recursive: true, force: true });
+  fs.rmSync(path.join(outDir, "manifest.json"), { force: true });
+  for (const rel of keep) {
+    const dest = path.join(OUT, rel);
+    fs.mkdirSync(path.dirname(dest), { recursive: true });
+    if (stubs.has(rel)) {
+      const name = /^define\("([^"]+)"/.exec(read(rel))[1];
+      fs.writeFileSync(dest, `define("${name}",["exports"],(function(e){"use strict";e.monaco_contribution={}}));\n`);
+    } else {
+      fs.copyFileSync(path.join(SRC, rel), dest);
+    }
+  }
+
+  // the ts.worker editor.main asks for, under the name it asks for
+  const tsWorkerName = (/ts\.worker-[\w-]+\.js/.exec(read("editor/editor.main.js")) || [])[0];
+  let haveTsWorker = [...keep].some(f => /^assets\/ts\.worker-/.test(f));
+  if (TS_WORKER && !haveTsWorker) {
+    if (!tsWorkerName) throw new Error("editor.main.js does not name a ts.worker; --ts-worker is not needed");
+    fs.mkdirSync(path.join(OUT, "assets"), { recursive: true });
+    fs.copyFileSync(path.resolve(TS_WORKER), path.join(OUT, "assets", tsWorkerName));
+    haveTsWorker = true;
+  }
+  if (!haveTsWorker) console.warn(`warning: no ${tsWorkerName || "ts.worker"} (pass --ts-worker); JS language features will be off`);
+
+  const preloadDeps = [...new Set(coreModules)].map(f => "./" + f.replace(/\.js$/, ""));
+  fs.writeFileSync(path.join(OUT, "languaggify-preload.js"),
+    `define("${PRELOAD_MODULE}",${JSON.stringify(preloadDeps)},(function(){"use strict"}));\n`);
+
+  const outFiles = walk(OUT);
+  const before = { files: all.length, bytes: sizeOf(SRC, all) };
+  const after = { files: outFiles.length, bytes: sizeOf(OUT, outFiles) };
+  const manifest = {
+    source: path.relative(ROOT, SRC),
+    preload: PRELOAD_MODULE,
+    coreLanguages: CORE_LANGS,
+    lazyLanguages: Object.keys(langs).filter(id => !CORE_LANGS.includes(id)),
+    stubbed: [...stubs],
+    jsLanguageService: haveTsWorker,
+    before,
+    after
+  };
+  fs.writeFileSync(path.join(path.dirname(OUT), "manifest.json"), JSON.stringify(manifest, null, 2));
+
+  const mb = n => (n / 1048576).toFixed(2) + " MB";
+  console.log(`monaco:      ${before.files} files, ${mb(before.bytes)}`);
+  console.log(`monaco-min:  ${after.files} files, ${mb(after.bytes)}`);
+  console.log(`saved:       ${mb(before.bytes - after.bytes)} (${(100 * (1 - after.bytes / before.bytes)).toFixed(1)}%)`);
+}
+
+try {
+  main();
+} catch (err) {
+  console.error("Error: " + err.message);
+  process.exit(1);
+}